@@ -16,12 +16,21 @@ pub fn build(b: *std.Build) !void {
 
     const target = b.resolveTargetQuery(.{ .cpu_features_add = enabled_features });
     const optimize = b.standardOptimizeOption(.{});
+    const profiler = b.option(bool, "profiler", "Record cpu profiler zones (default: true)") orelse true;
+    const sanitize = b.option(Sanitizer, "sanitize", "Runtime checks: address (asan, ubsan, lsan) or thread (tsan) (default: none)") orelse .none;
+
+    var flags = std.ArrayList([]const u8){};
+    try flags.appendSlice(b.allocator, debug_flags);
+    if (!profiler) try flags.append(b.allocator, "-DFLUX_PROFILER=0");
+    if (sanitize == .address) try flags.appendSlice(b.allocator, runtime_check_flags);
+    const engine_flags = flags.items;
 
     const exe = b.addExecutable(.{
         .root_module = b.createModule(.{
             .target = target,
             .optimize = optimize,
             .link_libcpp = true,
+            .sanitize_thread = sanitize == .thread,
         }),
         .name = "flux",
     });
@@ -32,43 +41,22 @@ pub fn build(b: *std.Build) !void {
         "src/core/engine.cpp",
         "src/renderer/renderer.cpp",
         "src/input/input.cpp",
-    }, .flags = debug_flags });
-    try addCSourceFilesInDir(b, exe, "src/subsystems", debug_flags);
+    }, .flags = engine_flags });
+    try addCSourceFilesInDir(b, exe, "src/subsystems", engine_flags);
 
     // get VULKAN_SDK paths
     var env_map = try std.process.getEnvMap(b.allocator);
     defer env_map.deinit();
     const path = env_map.get("VULKAN_SDK") orelse @panic("failed to get VULKAN_SDK from envmap");
 
-    // dep srcs
-    try addCSourceFilesInDir(b, exe, "deps/src/imgui", &.{});
-    try addCSourceFilesInDir(b, exe, "deps/src/meshoptimizer", &.{});
-    try addCSourceFilesInDir(b, exe, "deps/src/vkb", &.{});
-    try addCSourceFilesInDir(b, exe, "deps/src/fastgltf", &.{});
-    try addCSourceFilesInDir(b, exe, "deps/src/simdjson", &.{});
-
-    // dep linking
-    exe.addLibraryPath(.{ .cwd_relative = try std.fmt.allocPrint(b.allocator, "{s}/lib", .{path}) });
-    exe.addLibraryPath(b.path("deps/lib"));
-    exe.root_module.linkSystemLibrary(if (target.result.os.tag == .windows) "vulkan-1" else "vulkan", .{});
-    exe.root_module.linkSystemLibrary("glfw3", .{});
+    try addDeps(b, exe, target, path);
+    addSanitizerRuntime(exe, sanitize);
     if (target.result.os.tag == .windows) {
         b.installBinFile("deps/lib/glfw3.dll", "glfw3.dll");
     } else {
         b.installBinFile("deps/lib/glfw3.so", "glfw3.so.0");
-        exe.root_module.addRPathSpecial("$ORIGIN");
     }
 
-    // dep includes
-    exe.addIncludePath(.{ .cwd_relative = try std.fmt.allocPrint(b.allocator, "{s}/include", .{path}) });
-    exe.addIncludePath(b.path("src"));
-    exe.addIncludePath(b.path("deps/include"));
-    exe.addIncludePath(b.path("deps/include/meshoptimizer"));
-    exe.addIncludePath(b.path("deps/include/imgui"));
-    exe.addIncludePath(b.path("deps/include/imgui/backends"));
-    exe.addIncludePath(b.path("deps/include/fastgltf"));
-    exe.addIncludePath(b.path("deps/include/simdjson"));
-
     try compileShaders(b, "res/shaders");
     b.installArtifact(exe);
 
@@ -78,10 +66,72 @@ pub fn build(b: *std.Build) !void {
     if (b.args) |args| run.addArgs(args);
     b.step("run", "Run the engine").dependOn(&run.step);
 
+    // benchmarks: subsystem and descriptor microbenchmarks in flux-bench, scene benchmarks run the
+    // engine headless on generated scenes. results land in zig-out/bench for comparison across commits
+    const bench_exe = b.addExecutable(.{
+        .root_module = b.createModule(.{
+            .target = target,
+            .optimize = optimize,
+            .link_libcpp = true,
+            .sanitize_thread = sanitize == .thread,
+        }),
+        .name = "flux-bench",
+    });
+    try addCSourceFilesInDir(b, bench_exe, "src/bench", engine_flags);
+    try addCSourceFilesInDir(b, bench_exe, "src/subsystems", engine_flags);
+    try addDeps(b, bench_exe, target, path);
+    addSanitizerRuntime(bench_exe, sanitize);
+    const install_bench = b.addInstallArtifact(bench_exe, .{});
+
+    const bench_step = b.step("bench", "Run micro and scene benchmarks");
+    const run_micro = b.addRunArtifact(bench_exe);
+    run_micro.step.dependOn(&install_bench.step);
+    run_micro.addArgs(&.{ "--out", "zig-out/bench/micro.json" });
+    if (b.args) |args| run_micro.addArgs(args);
+    bench_step.dependOn(&run_micro.step);
+
+    // name, --scene meshes,textures,instances
+    const scenes = [_][2][]const u8{
+        .{ "meshes", "256,0,256" },
+        .{ "textures", "64,512,512" },
+        .{ "instances", "16,16,16384" },
+    };
+    for (scenes) |scene| {
+        const run_scene = b.addRunArtifact(exe);
+        run_scene.step.dependOn(b.getInstallStep());
+        run_scene.addArgs(&.{ "--headless", "--frames", "600", "--scene", scene[1], "--bench", scene[0], "--bench-out" });
+        run_scene.addArg(b.fmt("zig-out/bench/scene_{s}.json", .{scene[0]}));
+        bench_step.dependOn(&run_scene.step);
+    }
+
+    // unit and stress tests for the engine subsystems, run with -Dsanitize=address or -Dsanitize=thread
+    // for the checked variants. pass a filter with `zig build test -- <suite/name>`
+    const test_exe = b.addExecutable(.{
+        .root_module = b.createModule(.{
+            .target = target,
+            .optimize = optimize,
+            .link_libcpp = true,
+            .sanitize_thread = sanitize == .thread,
+        }),
+        .name = "flux-test",
+    });
+    try addCSourceFilesInDir(b, test_exe, "src/tests", engine_flags);
+    try addCSourceFilesInDir(b, test_exe, "src/subsystems", engine_flags);
+    try addDeps(b, test_exe, target, path);
+    addSanitizerRuntime(test_exe, sanitize);
+    const install_test = b.addInstallArtifact(test_exe, .{});
+
+    const run_test = b.addRunArtifact(test_exe);
+    run_test.step.dependOn(&install_test.step);
+    if (b.args) |args| run_test.addArgs(args);
+    b.step("test", "Run unit and stress tests").dependOn(&run_test.step);
+
     // generate compile_commands.json
     var targets = std.ArrayList(*std.Build.Step.Compile){};
     defer targets.deinit(b.allocator);
     try targets.append(b.allocator, exe);
+    try targets.append(b.allocator, bench_exe);
+    try targets.append(b.allocator, test_exe);
     _ = zcc.createStep(b, "ccdb", try targets.toOwnedSlice(b.allocator));
 }
 
@@ -103,6 +153,7 @@ fn compileShaders(b: *std.Build, baseDirPath: []const u8) !void {
                 "-target",
                 "spirv",
                 "-fvk-use-entrypoint-name",
+                "-fvk-use-scalar-layout",
                 "-o",
             });
             const output = shader_comp.addOutputFileArg(dst);
@@ -112,6 +163,43 @@ fn compileShaders(b: *std.Build, baseDirPath: []const u8) !void {
     }
 }
 
+const Sanitizer = enum { none, address, thread };
+
+// zig links the tsan runtime itself (module sanitize_thread), the asan/ubsan runtimes come from the
+// system toolchain
+fn addSanitizerRuntime(c: *std.Build.Step.Compile, sanitize: Sanitizer) void {
+    if (sanitize != .address) return;
+    c.root_module.linkSystemLibrary("asan", .{});
+    c.root_module.linkSystemLibrary("ubsan", .{});
+}
+
+// dependency sources, libraries and include paths shared by every executable
+fn addDeps(b: *std.Build, c: *std.Build.Step.Compile, target: std.Build.ResolvedTarget, vulkan_sdk: []const u8) !void {
+    // dep srcs
+    try addCSourceFilesInDir(b, c, "deps/src/imgui", &.{});
+    try addCSourceFilesInDir(b, c, "deps/src/meshoptimizer", &.{});
+    try addCSourceFilesInDir(b, c, "deps/src/vkb", &.{});
+    try addCSourceFilesInDir(b, c, "deps/src/fastgltf", &.{});
+    try addCSourceFilesInDir(b, c, "deps/src/simdjson", &.{});
+
+    // dep linking
+    c.addLibraryPath(.{ .cwd_relative = try std.fmt.allocPrint(b.allocator, "{s}/lib", .{vulkan_sdk}) });
+    c.addLibraryPath(b.path("deps/lib"));
+    c.root_module.linkSystemLibrary(if (target.result.os.tag == .windows) "vulkan-1" else "vulkan", .{});
+    c.root_module.linkSystemLibrary("glfw3", .{});
+    if (target.result.os.tag != .windows) c.root_module.addRPathSpecial("$ORIGIN");
+
+    // dep includes
+    c.addIncludePath(.{ .cwd_relative = try std.fmt.allocPrint(b.allocator, "{s}/include", .{vulkan_sdk}) });
+    c.addIncludePath(b.path("src"));
+    c.addIncludePath(b.path("deps/include"));
+    c.addIncludePath(b.path("deps/include/meshoptimizer"));
+    c.addIncludePath(b.path("deps/include/imgui"));
+    c.addIncludePath(b.path("deps/include/imgui/backends"));
+    c.addIncludePath(b.path("deps/include/fastgltf"));
+    c.addIncludePath(b.path("deps/include/simdjson"));
+}
+
 fn addCSourceFilesInDir(b: *std.Build, c: *std.Build.Step.Compile, path: []const u8, flags: []const []const u8) !void {
     var dir = try b.build_root.handle.openDir(path, .{ .iterate = true });
     defer dir.close();
@@ -0,0 +1,29 @@
+// the renderer internals are header only and expect the vma implementation in the including tu
+#define VMA_IMPLEMENTATION
+#include "suites.hpp"
+#include <renderer/internal/descriptors.hpp>
+
+using namespace flux::renderer;
+
+// id bookkeeping only, no device is created. writes land in pendingWriteDescriptors and are dropped
+// instead of flushed, so this measures allocation, retirement and recycling of bindless ids
+void bench::suites::descriptors(Results* results, std::string_view filter) {
+    const std::string name = "descriptors/register_unregister";
+    if (name.find(filter) == std::string::npos) return;
+
+    constexpr u32 BATCH = 1024;
+    auto state = std::make_unique<RendererState>(RendererState{ .engine = nullptr });
+    std::array<CombinedSamplerId, BATCH> ids;
+
+    results->push_back(run(name, [&](u64 n) {
+        for (u64 i = 0; i < n; i += BATCH) {
+            for (auto& id : ids) id = descriptors::registerCombinedSampler(state.get(), VK_NULL_HANDLE, VK_NULL_HANDLE);
+            for (auto id : ids) descriptors::unregister(state.get(), id);
+            state->pendingWriteDescriptors.clear();
+            // retire every id immediately instead of waiting FRAME_OVERLAP frames
+            state->frameNumber += config::renderer::FRAME_OVERLAP;
+            descriptors::recycleRetired(state.get());
+        }
+    }));
+    print(results->back());
+}
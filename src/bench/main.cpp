@@ -0,0 +1,45 @@
+#include "suites.hpp"
+#include <subsystems/log.hpp>
+#include <subsystems/jobs.hpp>
+
+// flux-bench [--filter <substring>] [--out <results.json>]
+// flux-bench --compare <results.json> <baseline.json> [--tolerance <relative>]
+i32 main(i32 argc, char** argv) {
+    std::string_view filter;
+    std::filesystem::path out;
+    std::filesystem::path compare[2];
+    f64 tolerance = config::bench::REGRESSION_TOLERANCE;
+    for (i32 i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--out" && i + 1 < argc) out = argv[++i];
+        else if (arg == "--tolerance" && i + 1 < argc) tolerance = std::strtod(argv[++i], nullptr);
+        else if (arg == "--compare" && i + 2 < argc) { compare[0] = argv[++i]; compare[1] = argv[++i]; }
+        else log::warn(std::format("ignoring unknown or incomplete argument: {}", arg));
+    }
+
+    // gate mode, nonzero exit on regressions so ci can fail the run
+    if (!compare[0].empty()) {
+        auto current = bench::readJson(compare[0]);
+        auto baseline = bench::readJson(compare[1]);
+        if (!current || !baseline) {
+            log::error("failed to read benchmark results");
+            return EXIT_FAILURE;
+        }
+        const u32 regressions = bench::compare(*current, *baseline, tolerance);
+        log::debug(std::format("{} regressions over {:.0f}%", regressions, tolerance * 100.0));
+        return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    jobs::init();
+    bench::suites::Results results;
+    bench::suites::subsystems(&results, filter);
+    bench::suites::descriptors(&results, filter);
+    jobs::deinit();
+
+    if (!out.empty() && !bench::writeJson(out, results)) {
+        log::error(std::format("failed to write {}", out.string()));
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,110 @@
+#include "suites.hpp"
+#include <subsystems/log.hpp>
+#include <subsystems/math.hpp>
+#include <subsystems/allocators.hpp>
+#include <subsystems/jobs.hpp>
+
+namespace flux::bench::suites {
+    static void add(Results* results, std::string_view filter, const std::string& name, const std::function<void(u64)>& fn) {
+        if (name.find(filter) == std::string::npos) return;
+        results->push_back(run(name, fn));
+        print(results->back());
+    }
+}
+
+void bench::suites::subsystems(Results* results, std::string_view filter) {
+    //---------------------------------------------------
+    // |>~ LOG ~<|
+    //---------------------------------------------------
+    // output goes to the null device so flushes cost a write call but no terminal time
+    FILE* null = std::fopen(
+#ifdef _WIN32
+        "NUL",
+#else
+        "/dev/null",
+#endif
+        "w");
+    if (null) {
+        log::setOutputFile(null);
+        add(results, filter, "log/buffered", [](u64 n) {
+            for (u64 i = 0; i < n; i++) log::buffered("benchmark message with a few words in it");
+        });
+        add(results, filter, "log/buffered_format", [](u64 n) {
+            for (u64 i = 0; i < n; i++) log::buffered(std::format("frame {} took {:.3f} ms", i, (f64)i * .001));
+        });
+        add(results, filter, "log/unbuffered", [](u64 n) {
+            for (u64 i = 0; i < n; i++) log::unbuffered("benchmark message with a few words in it");
+        });
+        log::flush();
+        log::setOutputFile(config::log::OUTPUT_FILE);
+        std::fclose(null);
+    }
+
+    //---------------------------------------------------
+    // |>~ ALLOCATORS ~<|
+    //---------------------------------------------------
+    constexpr usize ALLOCATIONS = 1024;
+    constexpr usize SIZE = 64;
+    add(results, filter, "alloc/malloc_free", [](u64 n) {
+        std::array<void*, ALLOCATIONS> blocks;
+        for (u64 i = 0; i < n; i += ALLOCATIONS) {
+            for (auto& block : blocks) block = std::malloc(SIZE);
+            doNotOptimize(blocks);
+            for (auto* block : blocks) std::free(block);
+        }
+    });
+    add(results, filter, "alloc/arena", [](u64 n) {
+        auto arena = alloc::createArena(ALLOCATIONS * SIZE);
+        for (u64 i = 0; i < n; i += ALLOCATIONS) {
+            for (usize j = 0; j < ALLOCATIONS; j++) doNotOptimize(alloc::allocate(&arena, SIZE));
+            alloc::reset(&arena);
+        }
+        alloc::destroy(&arena);
+    });
+    add(results, filter, "alloc/pool", [](u64 n) {
+        auto pool = alloc::createPool(SIZE, ALLOCATIONS);
+        std::array<void*, ALLOCATIONS> blocks;
+        for (u64 i = 0; i < n; i += ALLOCATIONS) {
+            for (auto& block : blocks) block = alloc::allocate(&pool);
+            doNotOptimize(blocks);
+            for (auto* block : blocks) alloc::deallocate(&pool, block);
+        }
+        alloc::destroy(&pool);
+    });
+
+    //---------------------------------------------------
+    // |>~ MATH ~<|
+    //---------------------------------------------------
+    add(results, filter, "math/cmpF32", [](u64 n) {
+        f32 a = 1.f;
+        u32 equal = 0;
+        for (u64 i = 0; i < n; i++) {
+            equal += math::cmpF32(a, 1.f + (f32)(i & 15) * 1e-6f);
+            doNotOptimize(a);
+        }
+        doNotOptimize(equal);
+    });
+    add(results, filter, "math/rndF32", [](u64 n) {
+        for (u64 i = 0; i < n; i++) doNotOptimize(math::rndF32());
+    });
+    add(results, filter, "math/view_projection", [](u64 n) {
+        glm::mat4 result(1.f);
+        for (u64 i = 0; i < n; i++) {
+            const glm::mat4 view = glm::lookAt(glm::vec3((f32)(i & 7), 1.f, 5.f), glm::vec3(0.f), glm::vec3(0.f, 1.f, 0.f));
+            result = glm::perspective(1.2f, 16.f / 9.f, .1f, 1000.f) * view;
+            doNotOptimize(result);
+        }
+    });
+
+    //---------------------------------------------------
+    // |>~ JOBS ~<|
+    //---------------------------------------------------
+    add(results, filter, "jobs/run_wait", [](u64 n) {
+        jobs::Counter counter;
+        std::atomic<u64> sum = 0;
+        for (u64 i = 0; i < n; i++)
+            jobs::run(&counter, [&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+        jobs::wait(&counter);
+        doNotOptimize(sum);
+    });
+}
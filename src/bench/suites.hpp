@@ -0,0 +1,11 @@
+#pragma once
+#include <common.hpp>
+#include <subsystems/bench.hpp>
+
+// every suite appends its results, filter skips benchmarks whose name does not contain it
+namespace flux::bench::suites {
+    using Results = std::vector<Result>;
+
+    void subsystems(Results* results, std::string_view filter);
+    void descriptors(Results* results, std::string_view filter);
+}
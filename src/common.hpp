@@ -26,6 +26,8 @@
 #include <filesystem>
 #include <span>
 #include <unordered_map>
+#include <memory>
+#include <optional>
 
 //---------------------------------------------------
 // |>~ BASE TYPES ~<|
@@ -1,6 +1,11 @@
 #pragma once
 #include <common.hpp>
 
+// cpu profiler zones, set to 0 (zig build -Dprofiler=false) to compile them out entirely
+#ifndef FLUX_PROFILER
+    #define FLUX_PROFILER 1
+#endif
+
 namespace flux::config {
 
     static const std::string ENGINE_NAME = "flux";
@@ -8,10 +13,31 @@ namespace flux::config {
 
     static constexpr usize WINDOW_WIDTH = 800;
     static constexpr usize WINDOW_HEIGHT = 600;
+    static constexpr u32 HEADLESS_FRAME_COUNT = 600;   // used when --frames is not given
 
     namespace log {
         static FILE* OUTPUT_FILE = stderr;
         static constexpr usize BUFFER_SIZE = 8 * 1024 * 1024; // 8mb
         static constexpr usize BUFFER_FLUSH_CAPACITY = usize(BUFFER_SIZE * .75f);
     }
+
+    namespace bench {
+        static constexpr u32 WARMUP_REPETITIONS = 3;
+        static constexpr u32 REPETITIONS = 30;
+        static constexpr u64 MIN_REPETITION_NS = 1000000;  // 1ms, iteration count is calibrated to reach this
+        static constexpr u32 WARMUP_FRAMES = 60;            // headless scene runs, not sampled
+        static constexpr u32 SCENE_TEXTURE_SIZE = 256;      // synthetic scene textures, see --scene
+        static constexpr f64 REGRESSION_TOLERANCE = 0.1;    // relative median slowdown reported by compare
+    }
+
+    namespace test {
+        static constexpr u32 STRESS_THREADS = 8;            // threads hammering a subsystem at once
+        static constexpr u32 STRESS_ITERATIONS = 20000;     // operations per stress thread
+    }
+
+    namespace profiler {
+        static constexpr usize THREAD_BUFFER_SIZE = 32 * 1024;  // zones kept per thread, oldest get overwritten
+        static constexpr usize FRAME_HISTORY = 256;             // frame marks kept
+        static const std::filesystem::path TRACE_PATH = "trace.json";
+    }
 }
\ No newline at end of file
@@ -7,37 +7,112 @@
 #include <subsystems/log.hpp>
 #include <subsystems/utility.hpp>
 #include <subsystems/math.hpp>
+#include <subsystems/jobs.hpp>
+#include <subsystems/profiler.hpp>
+#include <subsystems/bench.hpp>
 
 static void glfwErrorCallback(i32 error, const char* description) {
     log::unbuffered(std::format("GLFW Error {}: {}", error, description), log::level::ERROR);
 }
 
+// --headless, --frames <n>, --size <w>x<h>, --capture <dir>, --capture-interval <n>,
+// --scene <meshes>,<textures>,<instances>, --bench <name>, --bench-out <path>,
+// --present-mode <fifo|fifo_relaxed|mailbox|immediate>, --fps-limit <n>, --low-latency,
+// --dynamic-resolution <ms>
+engine::Options engine::parseOptions(i32 argc, char** argv) {
+    Options options;
+    for (i32 i = 1; i < argc; i++) {
+        const std::string_view arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--headless") {
+            options.headless = true;
+        } else if (arg == "--frames" && value) {
+            options.frameCount = (u32)std::strtoul(value, nullptr, 10);
+            i++;
+        } else if (arg == "--size" && value && std::sscanf(value, "%ux%u", &options.width, &options.height) == 2) {
+            i++;
+        } else if (arg == "--capture" && value) {
+            options.captureDir = value;
+            i++;
+        } else if (arg == "--capture-interval" && value) {
+            options.captureInterval = (u32)std::strtoul(value, nullptr, 10);
+            i++;
+        } else if (arg == "--scene" && value && std::sscanf(value, "%u,%u,%u",
+                &options.scene.meshes, &options.scene.textures, &options.scene.instances) == 3) {
+            i++;
+        } else if (arg == "--bench" && value) {
+            options.benchName = value;
+            i++;
+        } else if (arg == "--bench-out" && value) {
+            options.benchOut = value;
+            i++;
+        } else if (arg == "--present-mode" && value) {
+            const std::string_view mode = value;
+            if (mode == "fifo") options.presentMode = PresentMode::FIFO;
+            else if (mode == "fifo_relaxed") options.presentMode = PresentMode::FIFO_RELAXED;
+            else if (mode == "mailbox") options.presentMode = PresentMode::MAILBOX;
+            else if (mode == "immediate") options.presentMode = PresentMode::IMMEDIATE;
+            else log::warn(std::format("unknown present mode: {}", mode));
+            i++;
+        } else if (arg == "--fps-limit" && value) {
+            options.fpsLimit = std::max(std::strtof(value, nullptr), 0.f);
+            i++;
+        } else if (arg == "--low-latency") {
+            options.lowLatency = true;
+        } else if (arg == "--dynamic-resolution" && value) {
+            options.dynamicResolutionMs = std::max(std::strtof(value, nullptr), 0.f);
+            i++;
+        } else {
+            log::warn(std::format("ignoring unknown or incomplete argument: {}", arg));
+        }
+    }
+
+    // headless runs always terminate
+    if (options.headless && options.frameCount == 0) options.frameCount = config::HEADLESS_FRAME_COUNT;
+    if (!options.captureDir.empty() && !options.headless) log::warn("--capture is only supported in headless mode");
+    if (!options.benchName.empty() && options.frameCount == 0) log::warn("--bench needs --frames or --headless to finish");
+    if (options.dynamicResolutionMs > 0.f && options.headless) log::warn("--dynamic-resolution is ignored in headless mode");
+    return options;
+}
+
 void engine::init(EngineState* state) {
+    PROFILE_THREAD("main");
+    PROFILE_ZONE("engine init");
 
-    // init glfw
-    log::debug("initialising glfw");
-    glfwSetErrorCallback(glfwErrorCallback);
-    if (!glfwInit()) {
-        log::error("failed to init glfw");
-        utility::exitWithFailure();
-    }
+    // init job system
+    log::debug("initialising job system");
+    jobs::init();
     state->deinitStack.emplace_back([] {
-        log::debug("deinitialising glfw");
-        glfwTerminate();
+        log::debug("deinitialising job system");
+        jobs::deinit();
     });
 
-    // create window
-    log::debug("creating window");
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
-    if (!(state->window = glfwCreateWindow(config::WINDOW_WIDTH, config::WINDOW_HEIGHT, config::APP_NAME.c_str(), nullptr, nullptr))) {
-        log::error("failed to create window");
-        utility::exitWithFailure();
+    // init glfw and window, skipped when headless
+    if (!state->options.headless) {
+        log::debug("initialising glfw");
+        glfwSetErrorCallback(glfwErrorCallback);
+        if (!glfwInit()) {
+            log::error("failed to init glfw");
+            utility::exitWithFailure();
+        }
+        state->deinitStack.emplace_back([] {
+            log::debug("deinitialising glfw");
+            glfwTerminate();
+        });
+
+        // create window
+        log::debug("creating window");
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
+        if (!(state->window = glfwCreateWindow((i32)state->options.width, (i32)state->options.height, config::APP_NAME.c_str(), nullptr, nullptr))) {
+            log::error("failed to create window");
+            utility::exitWithFailure();
+        }
+        state->deinitStack.emplace_back([state] {
+            log::debug("destroying window");
+            glfwDestroyWindow(state->window);
+        });
     }
-    state->deinitStack.emplace_back([state] {
-        log::debug("destroying window");
-        glfwDestroyWindow(state->window);
-    });
 
     // init renderer
     log::debug("initialising renderer");
@@ -78,10 +153,60 @@ void engine::run(EngineState* state) {
         utility::exitWithFailure();
     }
 
-    while (!glfwWindowShouldClose(state->window)) {
-        glfwPollEvents();
-    
-        input::update(state->input);
-        renderer::draw(state->renderer);
+    // benchmark runs sample cpu frame time around the whole loop body and the gpu "frame" scope, which
+    // trails by FRAME_OVERLAP frames. the first WARMUP_FRAMES cover pipeline and texture warmup
+    const bool benchmark = !state->options.benchName.empty();
+    std::vector<f64> cpuSamples, gpuSamples;
+    auto frameStart = std::chrono::steady_clock::now();
+
+    const auto start = std::chrono::steady_clock::now();
+    u32 frame = 0;
+    for (; state->options.frameCount == 0 || frame < state->options.frameCount; frame++) {
+        if (state->window && glfwWindowShouldClose(state->window)) break;
+        if (benchmark) {
+            const auto now = std::chrono::steady_clock::now();
+            if (frame > config::bench::WARMUP_FRAMES) {
+                cpuSamples.push_back(std::chrono::duration<f64, std::milli>(now - frameStart).count());
+                for (const auto& stats : state->renderer->gpuProfiler.stats)
+                    if (stats.parent == renderer::GpuScopeStats::ROOT && std::string_view(stats.name) == "frame" && stats.sampleCount > 0)
+                        gpuSamples.push_back(stats.last);
+            }
+            frameStart = now;
+        }
+        PROFILE_FRAME();
+        {
+            // frame limiter and present wait, before input so it is sampled as late as possible
+            PROFILE_ZONE("pace");
+            renderer::pace(state->renderer);
+        }
+        if (state->window) {
+            PROFILE_ZONE("poll events");
+            glfwPollEvents();
+            // nothing to present while minimised, block instead of spinning
+            while (utility::getWindowSize(state) == std::pair<u32, u32>{ 0, 0 } && !glfwWindowShouldClose(state->window))
+                glfwWaitEvents();
+        }
+        {
+            PROFILE_ZONE("input");
+            input::update(state->input);
+        }
+        {
+            PROFILE_ZONE("render");
+            renderer::draw(state->renderer);
+        }
+    }
+
+    const f64 elapsed = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    log::debug(std::format("rendered {} frames in {:.1f} ms ({:.3f} ms/frame)", frame, elapsed, elapsed / std::max(frame, 1u)));
+
+    if (benchmark) {
+        const std::array results = {
+            bench::summarize(state->options.benchName + "/cpu_frame", std::move(cpuSamples), "ms"),
+            bench::summarize(state->options.benchName + "/gpu_frame", std::move(gpuSamples), "ms"),
+        };
+        for (const auto& result : results)
+            bench::print(result);
+        if (!state->options.benchOut.empty() && !bench::writeJson(state->options.benchOut, results))
+            log::warn(std::format("failed to write {}", state->options.benchOut.string()));
     }
 }
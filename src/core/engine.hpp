@@ -1,5 +1,6 @@
 #pragma once
 #include <common.hpp>
+#include <config.hpp>
 
 // silence clang for external includes
 #pragma clang diagnostic push
@@ -8,11 +9,42 @@
 #pragma clang diagnostic pop
 
 namespace flux::engine {
+    // swapchain present modes, mapped to VkPresentModeKHR by the renderer
+    enum class PresentMode : u8 {
+        FIFO,           // vsync, always supported
+        FIFO_RELAXED,   // vsync, late frames tear instead of waiting a full interval
+        MAILBOX,        // uncapped, newest frame replaces the queued one, no tearing
+        IMMEDIATE,      // uncapped, tears
+    };
+
+    // runtime options from the command line, see parseOptions
+    struct Options {
+        bool headless = false;                  // no window, surface or swapchain, renders into the draw image only
+        u32 width = config::WINDOW_WIDTH;
+        u32 height = config::WINDOW_HEIGHT;
+        u32 frameCount = 0;                     // stop after this many frames, 0 runs until the window closes
+        std::filesystem::path captureDir = {};  // headless only, write rendered frames here when set
+        u32 captureInterval = 0;                // capture every n frames, 0 only captures the last one
+        PresentMode presentMode = PresentMode::FIFO;    // falls back when unsupported, see swapchain::selectPresentMode
+        f32 fpsLimit = 0.f;                     // frame limiter target, 0 is unlimited
+        bool lowLatency = false;                // wait for the previous present before sampling input, needs VK_KHR_present_wait
+        f32 dynamicResolutionMs = 0.f;          // gpu frame budget the render scale adapts to, 0 renders at full resolution
+        struct {
+            u32 meshes = 0;                     // > 0 replaces the scene file with generated content
+            u32 textures = 0;
+            u32 instances = 0;
+        } scene = {};
+        std::string benchName = {};             // record frame times under this name, see bench.hpp
+        std::filesystem::path benchOut = {};    // json results of the run, needs benchName
+    };
+
+    Options parseOptions(i32 argc, char** argv);
     void init(EngineState* state);
     void deinit(EngineState* state);
     void run(EngineState* state);
 
     struct EngineState {
+        Options options = {};
         bool initialised = false;
         GLFWwindow* window = nullptr;
 
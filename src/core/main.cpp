@@ -25,8 +25,8 @@
 //          ⠀⠀⠀⠀⣾⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⡄⠀⠀⠀⠀⠀⠀⠀⠀
 //          ⠀⠀⠀⢸⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⣿⡇⠀⠀⠀⠀⠀⠀⠀⠀
 
-i32 main() {
-    auto state = new EngineState;
+i32 main(i32 argc, char** argv) {
+    auto state = new EngineState{ .options = engine::parseOptions(argc, argv) };
 
     engine::init(state);
     engine::run(state);
@@ -14,6 +14,7 @@ void input::deinit(InputState* state) {
 }
 
 void input::update(InputState* state) {
+    if (!state->engine->window) return; // headless
     if (glfwGetKey(state->engine->window, GLFW_KEY_ESCAPE))
         glfwSetWindowShouldClose(state->engine->window, true);
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#pragma once
+#include "../renderer.hpp"
+
+// cpu block compression encoders used when cooking textures. quality is aimed at fast offline
+// cooking: endpoints come from the block bounding box (diagonal picked by covariance sign, inset
+// by 1/16 of the range) and indices are chosen by exhaustive nearest palette search.
+// bc7 only emits mode 6 (single subset rgba, 7 bit endpoints + p-bit, 4 bit indices)
+namespace flux::renderer::bcn {
+
+    enum class Format : u8 {
+        BC1,    // rgb, 1 bit alpha unused, 4bpp
+        BC3,    // rgba, 8bpp
+        BC4,    // r, 4bpp
+        BC5,    // rg, 8bpp
+        BC7,    // rgba, 8bpp
+    };
+
+    u32 blockSize(Format format) {
+        return (format == Format::BC1 || format == Format::BC4) ? 8 : 16;
+    }
+
+    VkFormat vkFormat(Format format, bool srgb) {
+        switch (format) {
+            case Format::BC1: return srgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+            case Format::BC3: return srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+            case Format::BC4: return VK_FORMAT_BC4_UNORM_BLOCK;
+            case Format::BC5: return VK_FORMAT_BC5_UNORM_BLOCK;
+            case Format::BC7: return srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        }
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    // 4x4 rgba8 texels, row major
+    using Block = std::array<u8, 64>;
+
+    // returns min/max endpoints over the given channels, swapped per channel so the
+    // segment follows the dominant diagonal of the block, and inset by 1/16 of the range
+    void boundingEndpoints(const Block& texels, u32 channels, i32* e0, i32* e1) {
+        i32 lo[4] = { 255, 255, 255, 255 }, hi[4] = { 0, 0, 0, 0 };
+        for (u32 t = 0; t < 16; t++) {
+            for (u32 c = 0; c < channels; c++) {
+                lo[c] = std::min(lo[c], (i32)texels[t * 4 + c]);
+                hi[c] = std::max(hi[c], (i32)texels[t * 4 + c]);
+            }
+        }
+
+        // covariance of each channel against the first decides the diagonal
+        i32 covariance[4] = {};
+        for (u32 t = 0; t < 16; t++) {
+            const i32 d0 = 2 * texels[t * 4] - (lo[0] + hi[0]);
+            for (u32 c = 1; c < channels; c++)
+                covariance[c] += d0 * (2 * texels[t * 4 + c] - (lo[c] + hi[c]));
+        }
+
+        for (u32 c = 0; c < channels; c++) {
+            const i32 inset = (hi[c] - lo[c]) >> 4;
+            e0[c] = hi[c] - inset;
+            e1[c] = lo[c] + inset;
+            if (covariance[c] < 0) std::swap(e0[c], e1[c]);
+        }
+    }
+
+    //---------------------------------------------------
+    // |>~ BC1 ~<|
+    //---------------------------------------------------
+
+    u16 packRgb565(const i32* c) {
+        return (u16)(((c[0] * 31 + 127) / 255) << 11 | ((c[1] * 63 + 127) / 255) << 5 | ((c[2] * 31 + 127) / 255));
+    }
+
+    void unpackRgb565(u16 v, i32* c) {
+        const i32 r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        c[0] = (r << 3) | (r >> 2);
+        c[1] = (g << 2) | (g >> 4);
+        c[2] = (b << 3) | (b >> 2);
+    }
+
+    // always emits 4 color mode (color0 > color1), as required for the color part of bc3
+    void encodeBC1(const Block& texels, u8* out) {
+        i32 e0[4], e1[4];
+        boundingEndpoints(texels, 3, e0, e1);
+        u16 c0 = packRgb565(e0), c1 = packRgb565(e1);
+
+        u32 indices = 0;
+        if (c0 != c1) {
+            if (c0 < c1) std::swap(c0, c1);
+            i32 palette[4][3];
+            unpackRgb565(c0, palette[0]);
+            unpackRgb565(c1, palette[1]);
+            for (u32 c = 0; c < 3; c++) {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            for (u32 t = 0; t < 16; t++) {
+                u32 best = 0;
+                i32 bestError = std::numeric_limits<i32>::max();
+                for (u32 p = 0; p < 4; p++) {
+                    i32 error = 0;
+                    for (u32 c = 0; c < 3; c++) {
+                        const i32 d = texels[t * 4 + c] - palette[p][c];
+                        error += d * d;
+                    }
+                    if (error < bestError) { bestError = error; best = p; }
+                }
+                indices |= best << (t * 2);
+            }
+        }
+
+        memcpy(out, &c0, 2);
+        memcpy(out + 2, &c1, 2);
+        memcpy(out + 4, &indices, 4);
+    }
+
+    //---------------------------------------------------
+    // |>~ BC4 ~<|
+    //---------------------------------------------------
+
+    // encodes a single channel of the block, also used for bc3 alpha and both bc5 channels
+    void encodeBC4(const Block& texels, u32 channel, u8* out) {
+        i32 lo = 255, hi = 0;
+        for (u32 t = 0; t < 16; t++) {
+            lo = std::min(lo, (i32)texels[t * 4 + channel]);
+            hi = std::max(hi, (i32)texels[t * 4 + channel]);
+        }
+
+        u64 bits = (u64)hi | (u64)lo << 8;
+        if (hi != lo) {
+            // 8 value mode: a0 > a1, indices 0 and 1 are the endpoints, 2..7 interpolate
+            i32 palette[8] = { hi, lo };
+            for (i32 i = 1; i < 7; i++)
+                palette[i + 1] = ((7 - i) * hi + i * lo) / 7;
+            for (u32 t = 0; t < 16; t++) {
+                u64 best = 0;
+                i32 bestError = std::numeric_limits<i32>::max();
+                for (u64 p = 0; p < 8; p++) {
+                    const i32 error = std::abs(texels[t * 4 + channel] - palette[p]);
+                    if (error < bestError) { bestError = error; best = p; }
+                }
+                bits |= best << (16 + t * 3);
+            }
+        }
+        memcpy(out, &bits, 8);
+    }
+
+    //---------------------------------------------------
+    // |>~ BC7 ~<|
+    //---------------------------------------------------
+
+    static constexpr i32 BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // quantizes an rgba endpoint to 7 bits per channel plus a shared p-bit, picking the p-bit with least error
+    void quantizeMode6Endpoint(const i32* endpoint, i32* quantized, i32* pbit) {
+        i32 bestError = std::numeric_limits<i32>::max();
+        for (i32 p = 0; p < 2; p++) {
+            i32 q[4], error = 0;
+            for (u32 c = 0; c < 4; c++) {
+                q[c] = std::clamp((endpoint[c] - p + 1) >> 1, 0, 127);
+                const i32 d = endpoint[c] - ((q[c] << 1) | p);
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                *pbit = p;
+                memcpy(quantized, q, sizeof(q));
+            }
+        }
+    }
+
+    void encodeBC7(const Block& texels, u8* out) {
+        i32 e[2][4], q[2][4], pbits[2];
+        boundingEndpoints(texels, 4, e[0], e[1]);
+        quantizeMode6Endpoint(e[0], q[0], &pbits[0]);
+        quantizeMode6Endpoint(e[1], q[1], &pbits[1]);
+
+        i32 palette[16][4];
+        for (u32 i = 0; i < 16; i++) {
+            for (u32 c = 0; c < 4; c++) {
+                const i32 a = (q[0][c] << 1) | pbits[0], b = (q[1][c] << 1) | pbits[1];
+                palette[i][c] = ((64 - BC7_WEIGHTS4[i]) * a + BC7_WEIGHTS4[i] * b + 32) >> 6;
+            }
+        }
+
+        u32 indices[16];
+        for (u32 t = 0; t < 16; t++) {
+            i32 bestError = std::numeric_limits<i32>::max();
+            for (u32 i = 0; i < 16; i++) {
+                i32 error = 0;
+                for (u32 c = 0; c < 4; c++) {
+                    const i32 d = texels[t * 4 + c] - palette[i][c];
+                    error += d * d;
+                }
+                if (error < bestError) { bestError = error; indices[t] = i; }
+            }
+        }
+
+        // the anchor index (texel 0) is stored without its msb, so it must be < 8
+        if (indices[0] >= 8) {
+            std::swap(q[0], q[1]);
+            std::swap(pbits[0], pbits[1]);
+            for (u32& index : indices) index = 15 - index;
+        }
+
+        // pack lsb first: mode 6 marker, endpoints per channel, p-bits, indices
+        u64 words[2] = {};
+        u32 bit = 0;
+        const auto write = [&](u64 value, u32 count) {
+            for (u32 i = 0; i < count; i++, bit++)
+                words[bit / 64] |= ((value >> i) & 1) << (bit % 64);
+        };
+        write(1 << 6, 7);
+        for (u32 c = 0; c < 4; c++) {
+            write((u64)q[0][c], 7);
+            write((u64)q[1][c], 7);
+        }
+        write((u64)pbits[0], 1);
+        write((u64)pbits[1], 1);
+        write(indices[0], 3);
+        for (u32 t = 1; t < 16; t++)
+            write(indices[t], 4);
+        memcpy(out, words, 16);
+    }
+
+    //---------------------------------------------------
+    // |>~ IMAGES ~<|
+    //---------------------------------------------------
+
+    usize encodedSize(Format format, u32 width, u32 height) {
+        return (usize)((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+    }
+
+    // encodes an rgba8 image, edge blocks of non multiple of 4 sizes replicate the last row/column
+    std::vector<u8> encode(Format format, std::span<const u8> pixels, u32 width, u32 height) {
+        const u32 blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const u32 size = blockSize(format);
+        std::vector<u8> result((usize)blocksX * blocksY * size);
+
+        Block block;
+        for (u32 by = 0; by < blocksY; by++) {
+            for (u32 bx = 0; bx < blocksX; bx++) {
+                for (u32 y = 0; y < 4; y++) {
+                    for (u32 x = 0; x < 4; x++) {
+                        const u32 px = std::min(bx * 4 + x, width - 1), py = std::min(by * 4 + y, height - 1);
+                        memcpy(&block[(y * 4 + x) * 4], &pixels[((usize)py * width + px) * 4], 4);
+                    }
+                }
+
+                u8* out = &result[((usize)by * blocksX + bx) * size];
+                switch (format) {
+                    case Format::BC1: encodeBC1(block, out); break;
+                    case Format::BC3: encodeBC4(block, 3, out); encodeBC1(block, out + 8); break;
+                    case Format::BC4: encodeBC4(block, 0, out); break;
+                    case Format::BC5: encodeBC4(block, 0, out); encodeBC4(block, 1, out + 8); break;
+                    case Format::BC7: encodeBC7(block, out); break;
+                }
+            }
+        }
+        return result;
+    }
+
+}
@@ -2,6 +2,7 @@
 #include "../renderer.hpp"
 #include "helpers.hpp"
 #include "vkstructs.hpp"
+#include "deletion.hpp"
 
 namespace flux::renderer::vkres {
 
@@ -29,8 +30,9 @@ namespace flux::renderer::vkres {
     //   it would be a good idea to move to worker thread
     // - also currently the staging buffer is being recreated each time,
     //   that should instead be kept and reused
-    GPUMeshBuffers uploadMesh(RendererState* state, std::span<u32> indices, std::span<Vertex> vertices) {
-        const usize vertexBufferSize = vertices.size() * sizeof(Vertex);
+    GPUMeshBuffers uploadMesh(RendererState* state, std::span<const u32> indices, std::span<const PackedVertex> vertices) {
+        PROFILE_ZONE("mesh upload");
+        const usize vertexBufferSize = vertices.size() * sizeof(PackedVertex);
         const usize indexBufferSize = indices.size() * sizeof(u32);
 
         GPUMeshBuffers meshBuffers = {
@@ -83,4 +85,109 @@ namespace flux::renderer::vkres {
         return meshBuffers;
     }
 
+    //---------------------------------------------------
+    // |>~ RESIDENT ~<|
+    //---------------------------------------------------
+    // device local arrays read through buffer device address, the owner keeps the cpu side copy and
+    // uploads only the element ranges that changed
+
+    struct Range {
+        u32 first;
+        u32 count;
+    };
+
+    // sorts and dedupes indices and merges them into ranges, clean gaps of up to maxGap elements are
+    // included when that saves a range
+    std::vector<Range> dirtyRanges(std::vector<u32>* indices, u32 maxGap) {
+        std::sort(indices->begin(), indices->end());
+        indices->erase(std::unique(indices->begin(), indices->end()), indices->end());
+
+        std::vector<Range> ranges;
+        for (u32 index : *indices) {
+            if (!ranges.empty() && index - (ranges.back().first + ranges.back().count) <= maxGap)
+                ranges.back().count = index - ranges.back().first + 1;
+            else
+                ranges.push_back({ .first = index, .count = 1 });
+        }
+        return ranges;
+    }
+
+    void memoryBarrier(VkCommandBuffer cmd, VkPipelineStageFlags2 srcStages, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStages, VkAccessFlags2 dstAccess) {
+        VkMemoryBarrier2 barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = srcStages,
+            .srcAccessMask = srcAccess,
+            .dstStageMask = dstStages,
+            .dstAccessMask = dstAccess,
+        };
+        VkDependencyInfo dependency = {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .memoryBarrierCount = 1,
+            .pMemoryBarriers = &barrier,
+        };
+        vkCmdPipelineBarrier2(cmd, &dependency);
+    }
+
+    // grows the buffer to at least size bytes, keeping the contents. the old buffer is retired so frames
+    // in flight keep reading it, its address changes
+    void reserve(RendererState* state, VkCommandBuffer cmd, ResidentBuffer* resident, usize size, usize minCapacity) {
+        if (size <= resident->capacity) return;
+        const usize capacity = std::max({ size, resident->capacity * 2, minCapacity });
+        AllocatedBuffer grown = createBuffer(state->allocator, capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY);
+        if (resident->buffer.buffer) {
+            VkBufferCopy region = { .size = resident->capacity };
+            vkCmdCopyBuffer(cmd, resident->buffer.buffer, grown.buffer, 1, &region);
+            deletion::retireBuffer(state, resident->buffer);
+            // later copies go over the grown contents
+            memoryBarrier(cmd, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        }
+
+        VkBufferDeviceAddressInfo addressInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = grown.buffer,
+        };
+        resident->buffer = grown;
+        resident->address = vkGetBufferDeviceAddress(state->device, &addressInfo);
+        resident->capacity = capacity;
+    }
+
+    // copies the element ranges through a staging buffer after growing the buffer to fit count elements.
+    // earlier frames may still read the elements being overwritten and their copies wrote what a grow
+    // reads or a range overwrites, so the copies wait for both. readStages of this frame wait for the
+    // copy. returns the number of elements uploaded
+    u32 upload(RendererState* state, VkCommandBuffer cmd, ResidentBuffer* resident, const void* elements, usize stride, usize count,
+        std::span<const Range> ranges, VkPipelineStageFlags2 readStages, usize minCapacity) {
+        if (ranges.empty()) return 0;
+        memoryBarrier(cmd, readStages | VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        reserve(state, cmd, resident, count * stride, minCapacity);
+
+        u32 uploaded = 0;
+        for (const Range& range : ranges) uploaded += range.count;
+        AllocatedBuffer staging = createBuffer(state->allocator, uploaded * stride, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+        deletion::retireBuffer(state, staging);
+
+        std::vector<VkBufferCopy> regions;
+        regions.reserve(ranges.size());
+        u8* data = (u8*)staging.allocation->GetMappedData();
+        usize offset = 0;
+        for (const Range& range : ranges) {
+            const usize size = range.count * stride;
+            memcpy(data + offset, (const u8*)elements + range.first * stride, size);
+            regions.push_back({ .srcOffset = offset, .dstOffset = range.first * stride, .size = size });
+            offset += size;
+        }
+        vkCmdCopyBuffer(cmd, staging.buffer, resident->buffer.buffer, (u32)regions.size(), regions.data());
+
+        memoryBarrier(cmd, VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, readStages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+        return uploaded;
+    }
+
+    void destroyResident(RendererState* state, ResidentBuffer* resident) {
+        if (resident->buffer.buffer) destroyBuffer(state->allocator, resident->buffer);
+        *resident = {};
+    }
+
 }
\ No newline at end of file
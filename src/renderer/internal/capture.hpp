@@ -0,0 +1,110 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "buffers.hpp"
+#include <core/engine.hpp>
+
+// silence clang for external includes
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+    #include <meshoptimizer/meshoptimizer.h>
+#pragma clang diagnostic pop
+
+// headless frame capture. the draw image is copied into a per frame readback buffer and written to
+// disk as a binary ppm once that frame's fence has signalled, so capturing never stalls the frame.
+// values are written like the swapchain blit would (clamped linear to unorm8)
+namespace flux::renderer::capture {
+
+    bool enabled(const RendererState* state) {
+        return state->engine->options.headless && !state->engine->options.captureDir.empty();
+    }
+
+    void init(RendererState* state) {
+        if (!enabled(state)) return;
+        std::error_code error;
+        std::filesystem::create_directories(state->engine->options.captureDir, error);
+        if (error) log::warn(std::format("failed to create capture directory: {}", error.message()));
+
+        const VkExtent3D extent = state->drawImage.image.extent;
+        for (auto& buffer : state->capture.readback)
+            buffer = vkres::createBuffer(state->allocator, (usize)extent.width * extent.height * 4 * sizeof(u16),
+                VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+        state->deinitStack.emplace_back([state] {
+            for (auto& buffer : state->capture.readback)
+                vkres::destroyBuffer(state->allocator, buffer);
+        });
+    }
+
+    bool requested(const RendererState* state) {
+        if (!enabled(state)) return false;
+        const auto& options = state->engine->options;
+        return options.captureInterval > 0
+            ? state->frameNumber % options.captureInterval == 0
+            : state->frameNumber + 1 == options.frameCount;
+    }
+
+    // draw image must be in TRANSFER_SRC_OPTIMAL
+    void record(RendererState* state, VkCommandBuffer cmd) {
+        if (!requested(state)) return;
+        const usize slot = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        const VkExtent3D extent = state->drawImage.image.extent;
+
+        VkBufferImageCopy region = {
+            .imageSubresource = { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT, .layerCount = 1 },
+            .imageExtent = extent,
+        };
+        vkCmdCopyImageToBuffer(cmd, state->drawImage.image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            state->capture.readback[slot].buffer, 1, &region);
+
+        VkBufferMemoryBarrier2 barrier = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+            .dstAccessMask = VK_ACCESS_2_HOST_READ_BIT,
+            .buffer = state->capture.readback[slot].buffer,
+            .size = VK_WHOLE_SIZE,
+        };
+        VkDependencyInfo dependency = {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1,
+            .pBufferMemoryBarriers = &barrier,
+        };
+        vkCmdPipelineBarrier2(cmd, &dependency);
+
+        state->capture.pending[slot] = true;
+        state->capture.frame[slot] = state->frameNumber;
+    }
+
+    void write(RendererState* state, usize slot) {
+        PROFILE_ZONE("capture write");
+        state->capture.pending[slot] = false;
+        const AllocatedBuffer& buffer = state->capture.readback[slot];
+        vmaInvalidateAllocation(state->allocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+
+        const VkExtent3D extent = state->drawImage.image.extent;
+        const u16* texels = (const u16*)buffer.allocation->GetMappedData();
+        std::vector<u8> pixels((usize)extent.width * extent.height * 3);
+        for (usize i = 0; i < (usize)extent.width * extent.height; i++)
+            for (usize c = 0; c < 3; c++)
+                pixels[i * 3 + c] = (u8)(std::clamp(meshopt_dequantizeHalf(texels[i * 4 + c]), 0.f, 1.f) * 255.f + .5f);
+
+        const auto path = state->engine->options.captureDir / std::format("frame_{:05}.ppm", state->capture.frame[slot]);
+        std::ofstream file(path, std::ios::binary);
+        file << std::format("P6\n{} {}\n255\n", extent.width, extent.height);
+        file.write((const char*)pixels.data(), (i64)pixels.size());
+        if (!file.good()) log::warn(std::format("failed to write capture: {}", path.string()));
+    }
+
+    // writes the capture of the frame whose fence was just waited on
+    void collect(RendererState* state) {
+        const usize slot = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        if (state->capture.pending[slot]) write(state, slot);
+    }
+
+    // writes every outstanding capture, the device must be idle
+    void flush(RendererState* state) {
+        for (usize slot = 0; slot < config::renderer::FRAME_OVERLAP; slot++)
+            if (state->capture.pending[slot]) write(state, slot);
+    }
+}
@@ -0,0 +1,304 @@
+#pragma once
+#include "../renderer.hpp"
+#include "vkstructs.hpp"
+#include "helpers.hpp"
+#include "descriptors.hpp"
+#include "pipelines.hpp"
+#include "hotreload.hpp"
+#include "gpuprofiler.hpp"
+
+// compute pipelines and dispatch. dispatch sizes are given in threads and turned into workgroup counts
+// with the workgroup size reflected from the shader, so changing numthreads needs no c++ change.
+// async work is recorded into a per frame command buffer of the compute queue family and submitted
+// to queue.compute
+namespace flux::renderer::compute {
+
+    // builds a compute pipeline on the global layout and keeps it rebuilt by hot reload, the workgroup
+    // size follows the shader
+    void buildPipeline(RendererState* state, ComputePipeline* pipeline, const std::string& shader, const PushConstantLayout& pushConstants,
+        pipelines::ComputePipelineBuilder builder = {}) {
+        builder.pipelineLayout = state->globalPipelineLayout;
+        builder.flags = descriptors::pipelineCreateFlags(state);
+        hotreload::buildPipeline(state, &pipeline->pipeline, { shader }, pushConstants,
+            [state, pipeline, builder](std::span<const VkShaderModule> modules, std::span<const ShaderReflection> reflections) mutable {
+                if (reflections[0].stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+                    log::warn("compute pipeline needs a compute shader");
+                    return VkPipeline(VK_NULL_HANDLE);
+                }
+                builder.setShader(modules[0]);
+                const VkPipeline built = builder.build(state->device, reflections);
+                if (built) pipeline->workgroupSize = reflections[0].workgroupSize;
+                return built;
+            });
+    }
+
+    void destroyPipeline(RendererState* state, ComputePipeline* pipeline) {
+        vkDestroyPipeline(state->device, pipeline->pipeline, nullptr);
+        *pipeline = {};
+    }
+
+    u32 groupCount(u32 threads, u32 workgroupSize) {
+        workgroupSize = std::max(workgroupSize, 1u);
+        return (threads + workgroupSize - 1) / workgroupSize;
+    }
+
+    // binds the pipeline and dispatches enough workgroups to cover width x height x depth threads.
+    // the global descriptors must be bound to the compute bind point
+    void dispatch(RendererState* state, VkCommandBuffer cmd, const ComputePipeline& pipeline, u32 width, u32 height = 1, u32 depth = 1) {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.pipeline);
+        vkCmdDispatch(cmd,
+            groupCount(width, pipeline.workgroupSize[0]),
+            groupCount(height, pipeline.workgroupSize[1]),
+            groupCount(depth, pipeline.workgroupSize[2]));
+        state->stats.dispatchCount++;
+    }
+
+    template <typename T>
+    void dispatch(RendererState* state, VkCommandBuffer cmd, const ComputePipeline& pipeline, const T& pushConstants, u32 width, u32 height = 1, u32 depth = 1) {
+        static_assert(sizeof(T) <= config::renderer::PUSH_CONSTANT_SIZE);
+        vkCmdPushConstants(cmd, state->globalPipelineLayout, VK_SHADER_STAGE_ALL, 0, sizeof(T), &pushConstants);
+        dispatch(state, cmd, pipeline, width, height, depth);
+    }
+
+    //---------------------------------------------------
+    // |>~ ASYNC ~<|
+    //---------------------------------------------------
+
+    // tasks run on the compute queue and overlap the graphics work of the same frame until graphics reaches
+    // the first stage that uses their resources. per frame the timeline semaphore orders
+    //   graphics n-1 -> compute n -> graphics n (from the stages using task resources on)
+    // and resources change queue family ownership compute -> graphics after every run, preserved ones also
+    // graphics -> compute at the end of the graphics frame before. without a separate compute family the
+    // tasks are recorded inline at the start of the graphics frame instead and no transfers are needed
+
+    static constexpr VkPipelineStageFlags2 COMPUTE_STAGES = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    static constexpr VkAccessFlags2 COMPUTE_ACCESS = VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT;
+
+    void init(RendererState* state) {
+        auto& async = state->asyncCompute;
+        async.enabled = config::renderer::ENABLE_ASYNC_COMPUTE && state->queueFamily.compute != state->queueFamily.graphics;
+        log::debug(async.enabled ? "async compute on a separate queue family" : "no separate compute queue family, compute tasks run inline");
+
+        auto poolInfo = vkstruct::cmdPoolCreateInfo(state->queueFamily.compute, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        for (auto& frame : state->frames) {
+            VK_CHECK(vkCreateCommandPool(state->device, &poolInfo, nullptr, &frame.computeCmdPool));
+            auto allocInfo = vkstruct::cmdBufferAllocInfo(frame.computeCmdPool, 1);
+            VK_CHECK(vkAllocateCommandBuffers(state->device, &allocInfo, &frame.computeCmdBuffer));
+        }
+
+        VkSemaphoreTypeCreateInfo typeInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0,
+        };
+        auto semaphoreInfo = vkstruct::semaphoreCreateInfo();
+        semaphoreInfo.pNext = &typeInfo;
+        VK_CHECK(vkCreateSemaphore(state->device, &semaphoreInfo, nullptr, &async.timeline));
+
+        state->deinitStack.emplace_back([state] {
+            for (auto& frame : state->frames)
+                vkDestroyCommandPool(state->device, frame.computeCmdPool, nullptr);
+            vkDestroySemaphore(state->device, state->asyncCompute.timeline, nullptr);
+        });
+    }
+
+    // tasks stay registered and run every frame. preserved resources must be in graphicsLayout when the task is
+    // added and at every graphics frame end, their first run is one frame later once graphics has released them
+    void addTask(RendererState* state, RendererState::AsyncComputeTask task) {
+        task.ready = !state->asyncCompute.enabled
+            || std::none_of(task.resources.begin(), task.resources.end(), [](const auto& resource) { return resource.preserve; });
+        state->asyncCompute.tasks.push_back(std::move(task));
+    }
+
+    struct Barriers {
+        std::vector<VkBufferMemoryBarrier2> buffers = {};
+        std::vector<VkImageMemoryBarrier2> images = {};
+
+        void add(const RendererState::AsyncComputeResource& resource,
+            VkPipelineStageFlags2 srcStages, VkAccessFlags2 srcAccess, VkPipelineStageFlags2 dstStages, VkAccessFlags2 dstAccess,
+            VkImageLayout oldLayout, VkImageLayout newLayout, u32 srcFamily = VK_QUEUE_FAMILY_IGNORED, u32 dstFamily = VK_QUEUE_FAMILY_IGNORED) {
+            if (resource.buffer) {
+                buffers.push_back({
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                    .srcStageMask = srcStages,
+                    .srcAccessMask = srcAccess,
+                    .dstStageMask = dstStages,
+                    .dstAccessMask = dstAccess,
+                    .srcQueueFamilyIndex = srcFamily,
+                    .dstQueueFamilyIndex = dstFamily,
+                    .buffer = *resource.buffer,
+                    .size = VK_WHOLE_SIZE,
+                });
+            } else {
+                images.push_back({
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                    .srcStageMask = srcStages,
+                    .srcAccessMask = srcAccess,
+                    .dstStageMask = dstStages,
+                    .dstAccessMask = dstAccess,
+                    .oldLayout = oldLayout,
+                    .newLayout = newLayout,
+                    .srcQueueFamilyIndex = srcFamily,
+                    .dstQueueFamilyIndex = dstFamily,
+                    .image = *resource.image,
+                    .subresourceRange = vkstruct::imageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT),
+                });
+            }
+        }
+
+        void record(VkCommandBuffer cmd) const {
+            if (buffers.empty() && images.empty()) return;
+            VkDependencyInfo dependency = {
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount = (u32)buffers.size(),
+                .pBufferMemoryBarriers = buffers.data(),
+                .imageMemoryBarrierCount = (u32)images.size(),
+                .pImageMemoryBarriers = images.data(),
+            };
+            vkCmdPipelineBarrier2(cmd, &dependency);
+        }
+    };
+
+    // resets and begins the current frame's compute command buffer with the global descriptors bound.
+    // the frame's graphics submission must wait on the async submission (directly or through later
+    // work), so the frame fence also covers reusing this command buffer
+    VkCommandBuffer beginAsync(RendererState* state) {
+        VkCommandBuffer cmd = getCurrentFrame(state).computeCmdBuffer;
+        VK_CHECK(vkResetCommandBuffer(cmd, 0));
+        auto beginInfo = vkstruct::cmdBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+        VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+        descriptors::bind(state, cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+        return cmd;
+    }
+
+    void submitAsync(RendererState* state, VkCommandBuffer cmd, std::span<const VkSemaphoreSubmitInfo> waits, std::span<const VkSemaphoreSubmitInfo> signals) {
+        VK_CHECK(vkEndCommandBuffer(cmd));
+        auto cmdInfo = vkstruct::cmdBufferSubmitInfo(cmd);
+        VkSubmitInfo2 submitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+            .waitSemaphoreInfoCount = (u32)waits.size(),
+            .pWaitSemaphoreInfos = waits.data(),
+            .commandBufferInfoCount = 1,
+            .pCommandBufferInfos = &cmdInfo,
+            .signalSemaphoreInfoCount = (u32)signals.size(),
+            .pSignalSemaphoreInfos = signals.data(),
+        };
+        PROFILE_ZONE("compute submit");
+        VK_CHECK(vkQueueSubmit2(state->queue.compute, 1, &submitInfo, nullptr));
+    }
+
+    VkSemaphoreSubmitInfo timelineInfo(RendererState* state, u64 value, VkPipelineStageFlags2 stages) {
+        auto info = vkstruct::semaphoreSubmitInfo(stages, state->asyncCompute.timeline);
+        info.value = value;
+        return info;
+    }
+
+    // records and submits the frame's ready tasks, before the frame's graphics submission. waits for the
+    // previous graphics submission, which released the preserved resources and is done with the others
+    void submit(RendererState* state) {
+        auto& async = state->asyncCompute;
+        async.computeValue = 0;
+        bool any = false;
+        for (auto& task : async.tasks) {
+            task.scheduled = async.enabled && task.ready;
+            any |= task.scheduled;
+        }
+        if (!any) return;
+
+        PROFILE_ZONE("async compute");
+        const u32 graphicsFamily = state->queueFamily.graphics, computeFamily = state->queueFamily.compute;
+        VkCommandBuffer cmd = beginAsync(state);
+
+        Barriers acquire, release;
+        for (const auto& task : async.tasks) {
+            if (!task.scheduled) continue;
+            for (const auto& resource : task.resources) {
+                if (resource.preserve)
+                    acquire.add(resource, COMPUTE_STAGES, VK_ACCESS_2_NONE, COMPUTE_STAGES, COMPUTE_ACCESS,
+                        resource.graphicsLayout, resource.computeLayout, graphicsFamily, computeFamily);
+                else
+                    acquire.add(resource, COMPUTE_STAGES, VK_ACCESS_2_NONE, COMPUTE_STAGES, COMPUTE_ACCESS,
+                        VK_IMAGE_LAYOUT_UNDEFINED, resource.computeLayout);
+                release.add(resource, COMPUTE_STAGES, COMPUTE_ACCESS, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE,
+                    resource.computeLayout, resource.graphicsLayout, computeFamily, graphicsFamily);
+            }
+        }
+        acquire.record(cmd);
+        for (const auto& task : async.tasks)
+            if (task.scheduled) task.record(cmd);
+        release.record(cmd);
+
+        async.computeValue = ++async.value;
+        const auto wait = timelineInfo(state, async.graphicsValue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        const auto signal = timelineInfo(state, async.computeValue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        submitAsync(state, cmd, { &wait, 1 }, { &signal, 1 });
+    }
+
+    VkPipelineStageFlags2 graphicsStages(const RendererState* state) {
+        VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+        for (const auto& task : state->asyncCompute.tasks)
+            if (task.scheduled)
+                for (const auto& resource : task.resources) stages |= resource.graphicsStages;
+        return stages ? stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+
+    // recorded at the start of the graphics frame, before anything uses task resources. takes ownership of
+    // the resources back from the compute queue, or records the tasks inline without async compute.
+    // afterwards every task resource is in its graphicsLayout
+    void acquire(RendererState* state, VkCommandBuffer cmd) {
+        auto& async = state->asyncCompute;
+        if (async.enabled) {
+            // source stages chain with the semaphore wait, see addGraphicsSemaphores
+            Barriers barriers;
+            for (const auto& task : async.tasks) {
+                if (!task.scheduled) continue;
+                for (const auto& resource : task.resources)
+                    barriers.add(resource, resource.graphicsStages, VK_ACCESS_2_NONE, resource.graphicsStages, resource.graphicsAccess,
+                        resource.computeLayout, resource.graphicsLayout, state->queueFamily.compute, state->queueFamily.graphics);
+            }
+            barriers.record(cmd);
+            return;
+        }
+
+        for (const auto& task : async.tasks) {
+            gpuprofiler::beginPass(state, cmd, task.name);
+            Barriers before, after;
+            for (const auto& resource : task.resources) {
+                before.add(resource, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT, COMPUTE_STAGES, COMPUTE_ACCESS,
+                    resource.preserve ? resource.graphicsLayout : VK_IMAGE_LAYOUT_UNDEFINED, resource.computeLayout);
+                after.add(resource, COMPUTE_STAGES, VK_ACCESS_2_SHADER_WRITE_BIT, resource.graphicsStages, resource.graphicsAccess,
+                    resource.computeLayout, resource.graphicsLayout);
+            }
+            before.record(cmd);
+            task.record(cmd);
+            after.record(cmd);
+            gpuprofiler::end(state, cmd);
+        }
+    }
+
+    // recorded at the end of the graphics frame, hands preserved resources to the compute queue for the next frame
+    void release(RendererState* state, VkCommandBuffer cmd) {
+        auto& async = state->asyncCompute;
+        if (!async.enabled) return;
+        Barriers barriers;
+        for (auto& task : async.tasks) {
+            for (const auto& resource : task.resources)
+                if (resource.preserve)
+                    barriers.add(resource, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_WRITE_BIT, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE,
+                        resource.graphicsLayout, resource.computeLayout, state->queueFamily.graphics, state->queueFamily.compute);
+            task.ready = true;
+        }
+        barriers.record(cmd);
+    }
+
+    // the graphics submission waits for the frame's compute submission only at the stages that use task
+    // resources, earlier graphics work overlaps the tasks. it signals the value the next compute submission waits on
+    void addGraphicsSemaphores(RendererState* state, std::vector<VkSemaphoreSubmitInfo>* waits, std::vector<VkSemaphoreSubmitInfo>* signals) {
+        auto& async = state->asyncCompute;
+        if (!async.enabled) return;
+        if (async.computeValue != 0)
+            waits->push_back(timelineInfo(state, async.computeValue, graphicsStages(state)));
+        async.graphicsValue = ++async.value;
+        signals->push_back(timelineInfo(state, async.graphicsValue, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT));
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+
+// deferred destruction for resources that frames in flight may still use. retiring appends a plain
+// record tagged with the current frame, collect destroys every record whose frame has completed in
+// one batch after the frame fence wait. records are in frame order, so the completed ones are always
+// a prefix of the queue. shutdown goes through the deinit stack instead, see flush
+namespace flux::renderer::deletion {
+
+    void retire(RendererState* state, DeletionType type, u64 handle, VmaAllocation allocation = nullptr) {
+        state->deletionQueue.push_back({ .handle = handle, .allocation = allocation, .frame = state->frameNumber, .type = type });
+    }
+
+    void retireBuffer(RendererState* state, const AllocatedBuffer& buffer) { retire(state, DeletionType::BUFFER, (u64)buffer.buffer, buffer.allocation); }
+    void retireImage(RendererState* state, const AllocatedImage& image) { retire(state, DeletionType::IMAGE, (u64)image.image, image.allocation); }
+    void retireImageView(RendererState* state, VkImageView view) { retire(state, DeletionType::IMAGE_VIEW, (u64)view); }
+    void retireSampler(RendererState* state, VkSampler sampler) { retire(state, DeletionType::SAMPLER, (u64)sampler); }
+    void retirePipeline(RendererState* state, VkPipeline pipeline) { retire(state, DeletionType::PIPELINE, (u64)pipeline); }
+    void retireSwapchain(RendererState* state, VkSwapchainKHR swapchain) { retire(state, DeletionType::SWAPCHAIN, (u64)swapchain); }
+
+    void destroy(RendererState* state, const Deletion& deletion) {
+        switch (deletion.type) {
+            case DeletionType::BUFFER: vmaDestroyBuffer(state->allocator, (VkBuffer)deletion.handle, deletion.allocation); break;
+            case DeletionType::IMAGE: vmaDestroyImage(state->allocator, (VkImage)deletion.handle, deletion.allocation); break;
+            case DeletionType::IMAGE_VIEW: vkDestroyImageView(state->device, (VkImageView)deletion.handle, nullptr); break;
+            case DeletionType::SAMPLER: vkDestroySampler(state->device, (VkSampler)deletion.handle, nullptr); break;
+            case DeletionType::PIPELINE: vkDestroyPipeline(state->device, (VkPipeline)deletion.handle, nullptr); break;
+            case DeletionType::SWAPCHAIN: vkDestroySwapchainKHR(state->device, (VkSwapchainKHR)deletion.handle, nullptr); break;
+        }
+    }
+
+    // number of leading records whose frame has completed, valid once the current frame's fence was waited on
+    usize ready(const RendererState* state) {
+        const auto& queue = state->deletionQueue;
+        const auto end = std::find_if(queue.begin(), queue.end(), [&](const Deletion& deletion) {
+            return state->frameNumber < deletion.frame + config::renderer::FRAME_OVERLAP;
+        });
+        return (usize)(end - queue.begin());
+    }
+
+    void collect(RendererState* state) {
+        const usize count = ready(state);
+        if (count == 0) return;
+        PROFILE_ZONE("deferred deletion");
+        auto& queue = state->deletionQueue;
+        for (usize i = 0; i < count; i++)
+            destroy(state, queue[i]);
+        queue.erase(queue.begin(), queue.begin() + (i64)count);
+    }
+
+    // destroys everything regardless of frame, the device must be idle
+    void flush(RendererState* state) {
+        for (const auto& deletion : state->deletionQueue)
+            destroy(state, deletion);
+        state->deletionQueue.clear();
+    }
+}
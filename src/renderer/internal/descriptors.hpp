@@ -1,30 +1,98 @@
 #pragma once
 #include "../renderer.hpp"
 #include "vkstructs.hpp"
+#include "buffers.hpp"
 
 namespace flux::renderer::descriptors {
 
-    void init(RendererState* state) {
-        static constexpr std::array<VkDescriptorType, 5> types = {
-            VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-            VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+    // indexed by Binding
+    static constexpr std::array<VkDescriptorType, (usize)Binding::COUNT> BINDING_TYPES = {
+        VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+        VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+    };
+    static constexpr std::array<u32, (usize)Binding::COUNT> BINDING_COUNTS = {
+        config::renderer::MAX_UNIFORM_BUFFER_COUNT,
+        config::renderer::MAX_DESCRIPTOR_COUNT,
+        config::renderer::MAX_DESCRIPTOR_COUNT,
+        config::renderer::MAX_DESCRIPTOR_COUNT,
+        config::renderer::MAX_DESCRIPTOR_COUNT,
+    };
+
+    static_assert(config::renderer::FRAME_OVERLAP <= 32, "frame slots of a pending write are a u32 mask");
+    static constexpr u32 ALL_SLOTS = (1u << config::renderer::FRAME_OVERLAP) - 1;
+
+    // sizes the buffer from the layout, one copy per frame slot, and maps it. descriptors are written
+    // straight into it with vkGetDescriptorEXT. slots start at offsets aligned for binding, fails without
+    // creating anything when one slot is past the range a bound descriptor buffer may cover
+    bool initDescriptorBuffer(RendererState* state) {
+        auto& db = state->descriptorBuffer;
+        db.getLayoutSize = (PFN_vkGetDescriptorSetLayoutSizeEXT)vkGetDeviceProcAddr(state->device, "vkGetDescriptorSetLayoutSizeEXT");
+        db.getBindingOffset = (PFN_vkGetDescriptorSetLayoutBindingOffsetEXT)vkGetDeviceProcAddr(state->device, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+        db.getDescriptor = (PFN_vkGetDescriptorEXT)vkGetDeviceProcAddr(state->device, "vkGetDescriptorEXT");
+        db.cmdBindBuffers = (PFN_vkCmdBindDescriptorBuffersEXT)vkGetDeviceProcAddr(state->device, "vkCmdBindDescriptorBuffersEXT");
+        db.cmdSetOffsets = (PFN_vkCmdSetDescriptorBufferOffsetsEXT)vkGetDeviceProcAddr(state->device, "vkCmdSetDescriptorBufferOffsetsEXT");
+        db.getAccelerationStructureAddress = (PFN_vkGetAccelerationStructureDeviceAddressKHR)vkGetDeviceProcAddr(state->device, "vkGetAccelerationStructureDeviceAddressKHR");
+
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT properties = { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT };
+        VkPhysicalDeviceProperties2 properties2 = { .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &properties };
+        vkGetPhysicalDeviceProperties2(state->physicalDevice, &properties2);
+        db.descriptorSizes = {
+            properties.uniformBufferDescriptorSize,
+            properties.combinedImageSamplerDescriptorSize,
+            properties.storageImageDescriptorSize,
+            properties.accelerationStructureDescriptorSize,
+            properties.storageBufferDescriptorSize,
+        };
+
+        VkDeviceSize layoutSize = 0;
+        db.getLayoutSize(state->device, state->globalDescriptorSetLayout, &layoutSize);
+        for (u32 i = 0; i < db.bindingOffsets.size(); i++)
+            db.getBindingOffset(state->device, state->globalDescriptorSetLayout, i, &db.bindingOffsets[i]);
+
+        // the layout holds combined image samplers, so it counts against both the resource and sampler limits
+        const VkDeviceSize alignment = std::max<VkDeviceSize>(properties.descriptorBufferOffsetAlignment, 1);
+        const VkDeviceSize slotSize = (layoutSize + alignment - 1) / alignment * alignment;
+        const VkDeviceSize bufferSize = slotSize * config::renderer::FRAME_OVERLAP;
+        if (layoutSize > properties.maxResourceDescriptorBufferRange || layoutSize > properties.maxSamplerDescriptorBufferRange
+            || bufferSize > properties.resourceDescriptorBufferAddressSpaceSize || bufferSize > properties.samplerDescriptorBufferAddressSpaceSize) {
+            log::warn(std::format("global descriptor layout needs {} bytes per frame slot, more than a descriptor buffer may bind", layoutSize));
+            return false;
+        }
+
+        db.slotSize = slotSize;
+        db.buffer = vkres::createBuffer(state->allocator, bufferSize,
+            VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+        db.mapped = (u8*)db.buffer.allocation->GetMappedData();
+        VkBufferDeviceAddressInfo addressInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = db.buffer.buffer,
         };
-        std::array<VkDescriptorSetLayoutBinding, types.size()> bindings = {};
-        std::array<VkDescriptorBindingFlags, types.size()> bindingFlags = {};
-        std::array<VkDescriptorPoolSize, types.size()> poolSizes = {};
+        db.address = vkGetBufferDeviceAddress(state->device, &addressInfo);
+        log::debug(std::format("using descriptor buffer backend ({} bytes per frame slot)", slotSize));
 
-        // descriptor set layout
+        state->deinitStack.emplace_back([state] {
+            vkres::destroyBuffer(state->allocator, state->descriptorBuffer.buffer);
+        });
+        return true;
+    }
+
+    // descriptor buffers are always update after bind and reject the flag
+    VkDescriptorSetLayout createLayout(RendererState* state, bool useBuffer) {
+        std::array<VkDescriptorSetLayoutBinding, BINDING_TYPES.size()> bindings = {};
+        std::array<VkDescriptorBindingFlags, BINDING_TYPES.size()> bindingFlags = {};
         for (u32 i = 0; i < bindings.size(); i++) {
             bindings[i] = {
                 .binding = i,
-                .descriptorType = types[i],
-                .descriptorCount = config::renderer::MAX_DESCRIPTOR_COUNT,
+                .descriptorType = BINDING_TYPES[i],
+                .descriptorCount = BINDING_COUNTS[i],
                 .stageFlags = VK_SHADER_STAGE_ALL,
             };
-            bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
-            poolSizes[i] = { types[i], config::renderer::MAX_DESCRIPTOR_COUNT };
+            bindingFlags[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+            if (!useBuffer) bindingFlags[i] |= VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
         }
         VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo = {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
@@ -34,13 +102,37 @@ namespace flux::renderer::descriptors {
         VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo = {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
             .pNext = &bindingFlagsInfo,
-            .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+            .flags = useBuffer
+                ? (VkDescriptorSetLayoutCreateFlags)VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT
+                : (VkDescriptorSetLayoutCreateFlags)VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
             .bindingCount = bindings.size(),
             .pBindings = bindings.data(),
         };
-        vkCreateDescriptorSetLayout(state->device, &descriptorSetLayoutCreateInfo, nullptr, &state->globalDescriptorSetLayout);
+        VkDescriptorSetLayout layout = nullptr;
+        vkCreateDescriptorSetLayout(state->device, &descriptorSetLayoutCreateInfo, nullptr, &layout);
+        return layout;
+    }
+
+    // creates the global bindless layout, backed by either a descriptor buffer or an update after bind pool
+    // and set. a layout too large for a descriptor buffer is recreated for the descriptor set backend
+    void init(RendererState* state) {
+        state->globalDescriptorSetLayout = createLayout(state, state->descriptorBuffer.enabled);
+        state->deinitStack.emplace_back([state] {
+            vkDestroyDescriptorSetLayout(state->device, state->globalDescriptorSetLayout, nullptr);
+        });
+
+        if (state->descriptorBuffer.enabled) {
+            if (initDescriptorBuffer(state)) return;
+            log::warn("falling back to the descriptor set backend");
+            vkDestroyDescriptorSetLayout(state->device, state->globalDescriptorSetLayout, nullptr);
+            state->descriptorBuffer.enabled = false;
+            state->globalDescriptorSetLayout = createLayout(state, false);
+        }
 
         // descriptor pool
+        std::array<VkDescriptorPoolSize, BINDING_TYPES.size()> poolSizes = {};
+        for (u32 i = 0; i < poolSizes.size(); i++)
+            poolSizes[i] = { BINDING_TYPES[i], BINDING_COUNTS[i] };
         VkDescriptorPoolCreateInfo poolInfo = {
             .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
             .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
@@ -61,63 +153,333 @@ namespace flux::renderer::descriptors {
 
         state->deinitStack.emplace_back([state] {
             vkDestroyDescriptorPool(state->device, state->globalDescriptorPool, nullptr);
-            vkDestroyDescriptorSetLayout(state->device, state->globalDescriptorSetLayout, nullptr);
         });
     }
 
-    void updatePending(RendererState* state) {
-        vkUpdateDescriptorSets(state->device, (u32)state->pendingWriteDescriptors.write.size(), state->pendingWriteDescriptors.write.data(), 0, nullptr);
-        state->pendingWriteDescriptors.write.clear();
-        state->pendingWriteDescriptors.info.clear();
+    // pipelines using the global layout must be created with these flags
+    VkPipelineCreateFlags pipelineCreateFlags(const RendererState* state) {
+        return state->descriptorBuffer.enabled ? VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT : 0;
     }
 
-    CombinedSamplerId registerCombinedSampler(RendererState* state, VkImageView view, VkSampler sampler) {
-        CombinedSamplerId result;
-        if (!state->availableDescriptorId.combinedSampler.empty()) {
-            result = state->availableDescriptorId.combinedSampler.back();
-            state->availableDescriptorId.combinedSampler.pop_back();
+    void bind(RendererState* state, VkCommandBuffer cmd, VkPipelineBindPoint bindPoint) {
+        if (!state->descriptorBuffer.enabled) {
+            vkCmdBindDescriptorSets(cmd, bindPoint, state->globalPipelineLayout, 0, 1, &state->globalDescriptorSet, 0, nullptr);
+            return;
         }
-        else result = (CombinedSamplerId)state->nextAvailableDecriptorId.combinedSampler++;
-        state->pendingWriteDescriptors.write.push_back({
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .dstSet = state->globalDescriptorSet,
-            .dstBinding = (u32)Binding::COMBINED_SAMPLER,
-            .dstArrayElement = (u32)result,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        VkDescriptorBufferBindingInfoEXT bindingInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+            .address = state->descriptorBuffer.address,
+            .usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT,
+        };
+        state->descriptorBuffer.cmdBindBuffers(cmd, 1, &bindingInfo);
+        const u32 bufferIndex = 0;
+        const VkDeviceSize offset = (state->frameNumber % config::renderer::FRAME_OVERLAP) * state->descriptorBuffer.slotSize;
+        state->descriptorBuffer.cmdSetOffsets(cmd, bindPoint, state->globalPipelineLayout, 0, 1, &bufferIndex, &offset);
+    }
+
+    //---------------------------------------------------
+    // |>~ IDS ~<|
+    //---------------------------------------------------
+
+    // reuses a recycled id when available, returns Id::INVALID once the binding is full
+    template<typename Id>
+    Id allocateId(std::vector<Id>& available, u32& next, Binding binding) {
+        if (!available.empty()) {
+            Id result = available.back();
+            available.pop_back();
+            return result;
+        }
+        if (next >= BINDING_COUNTS[(usize)binding]) {
+            log::warn(std::format("out of descriptors for binding {}", (u32)binding));
+            return Id::INVALID;
+        }
+        return (Id)next++;
+    }
+
+    void retire(RendererState* state, Binding binding, u32 id) {
+        state->retiredDescriptorIds.push_back({ .binding = binding, .id = id, .frame = state->frameNumber });
+    }
+
+    // frames up to the retiring one have completed once the fence FRAME_OVERLAP frames later was waited on
+    void recycleRetired(RendererState* state) {
+        auto& available = state->availableDescriptorId;
+        std::erase_if(state->retiredDescriptorIds, [&](const RendererState::RetiredDescriptorId& retired) {
+            if (state->frameNumber < retired.frame + config::renderer::FRAME_OVERLAP) return false;
+            switch (retired.binding) {
+                case Binding::UNIFORM_BUFFER: available.uniformBuffer.push_back((UniformBufferId)retired.id); break;
+                case Binding::COMBINED_SAMPLER: available.combinedSampler.push_back((CombinedSamplerId)retired.id); break;
+                case Binding::STORAGE_IMAGE: available.storageImage.push_back((StorageImageId)retired.id); break;
+                case Binding::ACCELERATION_STRUCTURE: available.accelerationStructure.push_back((AccelerationStructureId)retired.id); break;
+                case Binding::STORAGE_BUFFER: available.storageBuffer.push_back((StorageBufferId)retired.id); break;
+                case Binding::COUNT: break;
+            }
+            return true;
         });
-        state->pendingWriteDescriptors.info.emplace_back();
-        state->pendingWriteDescriptors.info.back().image = {
+    }
+
+    //---------------------------------------------------
+    // |>~ WRITES ~<|
+    //---------------------------------------------------
+
+    // descriptor buffer backend: writes go straight into the given frame slot's copy in the mapped buffer
+    void writeToBuffer(RendererState* state, const RendererState::PendingWriteDescriptor& entry, u32 slot) {
+        auto& db = state->descriptorBuffer;
+        VkDescriptorGetInfoEXT info = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+            .type = BINDING_TYPES[(usize)entry.binding],
+        };
+        VkDescriptorAddressInfoEXT addressInfo = { .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT };
+        if (entry.binding == Binding::UNIFORM_BUFFER || entry.binding == Binding::STORAGE_BUFFER) {
+            VkBufferDeviceAddressInfo bufferAddressInfo = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = entry.buffer.buffer,
+            };
+            addressInfo.address = vkGetBufferDeviceAddress(state->device, &bufferAddressInfo) + entry.buffer.offset;
+            addressInfo.range = entry.buffer.range;
+        }
+
+        switch (entry.binding) {
+            case Binding::UNIFORM_BUFFER: info.data.pUniformBuffer = &addressInfo; break;
+            case Binding::STORAGE_BUFFER: info.data.pStorageBuffer = &addressInfo; break;
+            case Binding::COMBINED_SAMPLER: info.data.pCombinedImageSampler = &entry.image; break;
+            case Binding::STORAGE_IMAGE: info.data.pStorageImage = &entry.image; break;
+            case Binding::ACCELERATION_STRUCTURE: {
+                VkAccelerationStructureDeviceAddressInfoKHR accelerationStructureInfo = {
+                    .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_DEVICE_ADDRESS_INFO_KHR,
+                    .accelerationStructure = entry.accelerationStructure,
+                };
+                info.data.accelerationStructure = db.getAccelerationStructureAddress(state->device, &accelerationStructureInfo);
+                break;
+            }
+            case Binding::COUNT: return;
+        }
+
+        const usize size = db.descriptorSizes[(usize)entry.binding];
+        const VkDeviceSize offset = slot * db.slotSize + db.bindingOffsets[(usize)entry.binding] + (VkDeviceSize)entry.element * size;
+        db.getDescriptor(state->device, &info, size, db.mapped + offset);
+        vmaFlushAllocation(state->allocator, db.buffer.allocation, offset, size);
+    }
+
+    // recycles retired ids and flushes pending writes. writes are sorted so runs of contiguous array
+    // elements in one binding become a single VkWriteDescriptorSet, and only the latest write to an
+    // element is kept. the descriptor buffer backend only has rewrites pending, they go into the current
+    // frame slot's copy, in order, until every slot has them. must run after the current frame's fence wait
+    void updatePending(RendererState* state) {
+        PROFILE_ZONE("descriptor updates");
+        recycleRetired(state);
+
+        auto& pending = state->pendingWriteDescriptors;
+        if (pending.empty()) return;
+
+        if (state->descriptorBuffer.enabled) {
+            const u32 slot = state->frameNumber % config::renderer::FRAME_OVERLAP;
+            for (auto& entry : pending) {
+                if ((entry.slots & (1u << slot)) == 0) continue;
+                writeToBuffer(state, entry, slot);
+                entry.slots &= ~(1u << slot);
+            }
+            std::erase_if(pending, [](const RendererState::PendingWriteDescriptor& entry) { return entry.slots == 0; });
+            return;
+        }
+
+        std::stable_sort(pending.begin(), pending.end(), [](const auto& a, const auto& b) {
+            return (a.binding != b.binding) ? a.binding < b.binding : a.element < b.element;
+        });
+
+        // reserved up front so the pointers taken below stay valid
+        std::vector<VkWriteDescriptorSet> writes;
+        std::vector<VkDescriptorImageInfo> imageInfos;
+        std::vector<VkDescriptorBufferInfo> bufferInfos;
+        std::vector<VkAccelerationStructureKHR> accelerationStructures;
+        std::vector<VkWriteDescriptorSetAccelerationStructureKHR> accelerationStructureWrites;
+        writes.reserve(pending.size());
+        imageInfos.reserve(pending.size());
+        bufferInfos.reserve(pending.size());
+        accelerationStructures.reserve(pending.size());
+        accelerationStructureWrites.reserve(pending.size());
+
+        for (usize i = 0; i < pending.size(); i++) {
+            const auto& entry = pending[i];
+            if (i + 1 < pending.size() && pending[i + 1].binding == entry.binding && pending[i + 1].element == entry.element)
+                continue;
+
+            const bool contiguous = !writes.empty() && writes.back().dstBinding == (u32)entry.binding &&
+                writes.back().dstArrayElement + writes.back().descriptorCount == entry.element;
+            if (!contiguous) {
+                writes.push_back({
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstSet = state->globalDescriptorSet,
+                    .dstBinding = (u32)entry.binding,
+                    .dstArrayElement = entry.element,
+                    .descriptorCount = 0,
+                    .descriptorType = BINDING_TYPES[(usize)entry.binding],
+                    .pImageInfo = imageInfos.data() + imageInfos.size(),
+                    .pBufferInfo = bufferInfos.data() + bufferInfos.size(),
+                });
+                if (entry.binding == Binding::ACCELERATION_STRUCTURE) {
+                    accelerationStructureWrites.push_back({
+                        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
+                        .accelerationStructureCount = 0,
+                        .pAccelerationStructures = accelerationStructures.data() + accelerationStructures.size(),
+                    });
+                    writes.back().pNext = &accelerationStructureWrites.back();
+                }
+            }
+            writes.back().descriptorCount++;
+
+            switch (entry.binding) {
+                case Binding::COMBINED_SAMPLER:
+                case Binding::STORAGE_IMAGE:
+                    imageInfos.push_back(entry.image);
+                    break;
+                case Binding::UNIFORM_BUFFER:
+                case Binding::STORAGE_BUFFER:
+                    bufferInfos.push_back(entry.buffer);
+                    break;
+                case Binding::ACCELERATION_STRUCTURE:
+                    accelerationStructures.push_back(entry.accelerationStructure);
+                    accelerationStructureWrites.back().accelerationStructureCount++;
+                    break;
+                case Binding::COUNT: break;
+            }
+        }
+
+        vkUpdateDescriptorSets(state->device, (u32)writes.size(), writes.data(), 0, nullptr);
+        pending.clear();
+    }
+
+    // a freshly allocated id is not used by any frame in flight, recycling waited for them. the buffer
+    // backend writes it into every frame slot right away, the set backend defers it to updatePending
+    void writeNew(RendererState* state, const RendererState::PendingWriteDescriptor& entry) {
+        if (!state->descriptorBuffer.enabled) {
+            state->pendingWriteDescriptors.push_back(entry);
+            return;
+        }
+        for (u32 slot = 0; slot < config::renderer::FRAME_OVERLAP; slot++)
+            writeToBuffer(state, entry, slot);
+    }
+
+    // a live id may be read by frames in flight, the buffer backend rewrites each frame slot's copy once
+    // updatePending runs for it
+    void write(RendererState* state, RendererState::PendingWriteDescriptor entry) {
+        entry.slots = ALL_SLOTS;
+        state->pendingWriteDescriptors.push_back(entry);
+    }
+
+    //---------------------------------------------------
+    // |>~ REGISTRATION ~<|
+    //---------------------------------------------------
+    // register* allocates an id and writes it, write* rewrites an already registered id (swapping the
+    // resource behind it in place), unregister retires the id for later recycling. the set backend cannot
+    // rewrite an id a frame in flight may use, register a new id and unregister the old one instead, the
+    // buffer backend rewrites frame slot by frame slot. all of it is main thread only. buffer ranges must be
+    // explicit since descriptor buffers cannot use VK_WHOLE_SIZE
+
+    RendererState::PendingWriteDescriptor uniformBufferWrite(UniformBufferId id, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        RendererState::PendingWriteDescriptor entry = { .binding = Binding::UNIFORM_BUFFER, .element = (u32)id };
+        entry.buffer = { .buffer = buffer, .offset = offset, .range = range };
+        return entry;
+    }
+
+    void writeUniformBuffer(RendererState* state, UniformBufferId id, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        write(state, uniformBufferWrite(id, buffer, offset, range));
+    }
+
+    UniformBufferId registerUniformBuffer(RendererState* state, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        auto result = allocateId(state->availableDescriptorId.uniformBuffer, state->nextAvailableDecriptorId.uniformBuffer, Binding::UNIFORM_BUFFER);
+        if (result != UniformBufferId::INVALID) writeNew(state, uniformBufferWrite(result, buffer, offset, range));
+        return result;
+    }
+
+    void unregister(RendererState* state, UniformBufferId id) {
+        if (id != UniformBufferId::INVALID) retire(state, Binding::UNIFORM_BUFFER, (u32)id);
+    }
+
+    RendererState::PendingWriteDescriptor storageBufferWrite(StorageBufferId id, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        RendererState::PendingWriteDescriptor entry = { .binding = Binding::STORAGE_BUFFER, .element = (u32)id };
+        entry.buffer = { .buffer = buffer, .offset = offset, .range = range };
+        return entry;
+    }
+
+    void writeStorageBuffer(RendererState* state, StorageBufferId id, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        write(state, storageBufferWrite(id, buffer, offset, range));
+    }
+
+    StorageBufferId registerStorageBuffer(RendererState* state, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        auto result = allocateId(state->availableDescriptorId.storageBuffer, state->nextAvailableDecriptorId.storageBuffer, Binding::STORAGE_BUFFER);
+        if (result != StorageBufferId::INVALID) writeNew(state, storageBufferWrite(result, buffer, offset, range));
+        return result;
+    }
+
+    void unregister(RendererState* state, StorageBufferId id) {
+        if (id != StorageBufferId::INVALID) retire(state, Binding::STORAGE_BUFFER, (u32)id);
+    }
+
+    RendererState::PendingWriteDescriptor combinedSamplerWrite(CombinedSamplerId id, VkImageView view, VkSampler sampler) {
+        RendererState::PendingWriteDescriptor entry = { .binding = Binding::COMBINED_SAMPLER, .element = (u32)id };
+        entry.image = {
             .sampler = sampler,
             .imageView = view,
             .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
         };
-        state->pendingWriteDescriptors.write.back().pImageInfo = &state->pendingWriteDescriptors.info.back().image;
+        return entry;
+    }
+
+    void writeCombinedSampler(RendererState* state, CombinedSamplerId id, VkImageView view, VkSampler sampler) {
+        write(state, combinedSamplerWrite(id, view, sampler));
+    }
+
+    CombinedSamplerId registerCombinedSampler(RendererState* state, VkImageView view, VkSampler sampler) {
+        auto result = allocateId(state->availableDescriptorId.combinedSampler, state->nextAvailableDecriptorId.combinedSampler, Binding::COMBINED_SAMPLER);
+        if (result != CombinedSamplerId::INVALID) writeNew(state, combinedSamplerWrite(result, view, sampler));
         return result;
     }
 
-    StorageImageId registerStorageImage(RendererState* state, VkImageView view) {
-        StorageImageId result;
-        if (!state->availableDescriptorId.storageImage.empty()) {
-            result = state->availableDescriptorId.storageImage.back();
-            state->availableDescriptorId.storageImage.pop_back();
-        }
-        else result = (StorageImageId)state->nextAvailableDecriptorId.storageImage++;
-        state->pendingWriteDescriptors.write.push_back({
-            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-            .dstSet = state->globalDescriptorSet,
-            .dstBinding = (u32)Binding::STORAGE_IMAGE,
-            .dstArrayElement = (u32)result,
-            .descriptorCount = 1,
-            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
-        });
-        state->pendingWriteDescriptors.info.emplace_back();
-        state->pendingWriteDescriptors.info.back().image = {
+    void unregister(RendererState* state, CombinedSamplerId id) {
+        if (id != CombinedSamplerId::INVALID) retire(state, Binding::COMBINED_SAMPLER, (u32)id);
+    }
+
+    RendererState::PendingWriteDescriptor storageImageWrite(StorageImageId id, VkImageView view) {
+        RendererState::PendingWriteDescriptor entry = { .binding = Binding::STORAGE_IMAGE, .element = (u32)id };
+        entry.image = {
             .imageView = view,
             .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
         };
-        state->pendingWriteDescriptors.write.back().pImageInfo = &state->pendingWriteDescriptors.info.back().image;
+        return entry;
+    }
+
+    void writeStorageImage(RendererState* state, StorageImageId id, VkImageView view) {
+        write(state, storageImageWrite(id, view));
+    }
+
+    StorageImageId registerStorageImage(RendererState* state, VkImageView view) {
+        auto result = allocateId(state->availableDescriptorId.storageImage, state->nextAvailableDecriptorId.storageImage, Binding::STORAGE_IMAGE);
+        if (result != StorageImageId::INVALID) writeNew(state, storageImageWrite(result, view));
         return result;
     }
 
-}
\ No newline at end of file
+    void unregister(RendererState* state, StorageImageId id) {
+        if (id != StorageImageId::INVALID) retire(state, Binding::STORAGE_IMAGE, (u32)id);
+    }
+
+    RendererState::PendingWriteDescriptor accelerationStructureWrite(AccelerationStructureId id, VkAccelerationStructureKHR accelerationStructure) {
+        RendererState::PendingWriteDescriptor entry = { .binding = Binding::ACCELERATION_STRUCTURE, .element = (u32)id };
+        entry.accelerationStructure = accelerationStructure;
+        return entry;
+    }
+
+    void writeAccelerationStructure(RendererState* state, AccelerationStructureId id, VkAccelerationStructureKHR accelerationStructure) {
+        write(state, accelerationStructureWrite(id, accelerationStructure));
+    }
+
+    AccelerationStructureId registerAccelerationStructure(RendererState* state, VkAccelerationStructureKHR accelerationStructure) {
+        auto result = allocateId(state->availableDescriptorId.accelerationStructure, state->nextAvailableDecriptorId.accelerationStructure, Binding::ACCELERATION_STRUCTURE);
+        if (result != AccelerationStructureId::INVALID) writeNew(state, accelerationStructureWrite(result, accelerationStructure));
+        return result;
+    }
+
+    void unregister(RendererState* state, AccelerationStructureId id) {
+        if (id != AccelerationStructureId::INVALID) retire(state, Binding::ACCELERATION_STRUCTURE, (u32)id);
+    }
+
+}
@@ -0,0 +1,170 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "materials.hpp"
+#include "meshes.hpp"
+#include <subsystems/jobs.hpp>
+
+// draw sorting. every frame each visible surface becomes a DrawCommand with a 64 bit key, the keys are
+// radix sorted and recording walks them in order, so draws sharing a pipeline, material and mesh end up
+// adjacent and binds or push constants are only recorded when they change. the sort is an LSD radix sort
+// on 8 bit digits, histograms and scatters are split into blocks over the job system, digits every key
+// shares are skipped
+namespace flux::renderer::draws {
+
+    // key layout from the most significant bit, earlier fields take precedence
+    enum class Pass : u32 { OPAQUE = 0, MASKED = 1 };   // alpha tested draws go after opaque ones
+    static constexpr u32 PASS_SHIFT = 60;
+    static constexpr u32 PIPELINE_SHIFT = 56;
+    static constexpr u32 MATERIAL_SHIFT = 40;
+    static constexpr u32 DEPTH_SHIFT = 24;
+    static constexpr u32 DEPTH_BUCKETS = 1u << 16;
+    static constexpr u32 MESH_MASK = (1u << DEPTH_SHIFT) - 1;
+
+    static constexpr u32 RADIX_BITS = 8;
+    static constexpr u32 RADIX = 1u << RADIX_BITS;
+
+    // fields wider than their slot are truncated, which only costs grouping, never correctness
+    u64 makeKey(Pass pass, u32 pipeline, u32 material, u32 depth, u32 mesh) {
+        return ((u64)((u32)pass & 0xf) << PASS_SHIFT)
+            | ((u64)(pipeline & 0xf) << PIPELINE_SHIFT)
+            | ((u64)(material & 0xffff) << MATERIAL_SHIFT)
+            | ((u64)(depth & 0xffff) << DEPTH_SHIFT)
+            | (u64)(mesh & MESH_MASK);
+    }
+
+    // front to back, logarithmic so nearby draws keep their resolution
+    u32 depthBucket(const Camera& camera, f32 distance) {
+        const f32 t = std::log(std::max(distance, camera.nearPlane) / camera.nearPlane) / std::log(camera.farPlane / camera.nearPlane);
+        return (u32)(std::clamp(t, 0.f, 1.f) * (f32)(DEPTH_BUCKETS - 1));
+    }
+
+    // stable, keys ends up sorted and scratch holds garbage
+    void radixSort(std::vector<DrawKey>* keys, std::vector<DrawKey>* scratch) {
+        PROFILE_ZONE("draw sort");
+        const u32 count = (u32)keys->size();
+        if (count < 2) return;
+        scratch->resize(count);
+
+        const u32 blocks = std::clamp(count / config::renderer::DRAW_SORT_MIN_BLOCK, 1u, jobs::workerCount() + 1);
+        const u32 blockSize = (count + blocks - 1) / blocks;
+        std::vector<std::array<u32, RADIX>> offsets(blocks);
+        DrawKey* src = keys->data();
+        DrawKey* dst = scratch->data();
+        for (u32 shift = 0; shift < 64; shift += RADIX_BITS) {
+            jobs::parallelFor(blocks, 1, [&](u32 begin, u32 end) {
+                for (u32 block = begin; block < end; block++) {
+                    auto& histogram = offsets[block];
+                    histogram.fill(0);
+                    for (u32 i = block * blockSize; i < std::min(count, (block + 1) * blockSize); i++)
+                        histogram[(src[i].key >> shift) & (RADIX - 1)]++;
+                }
+            });
+
+            // digit major, block minor prefix sum keeps the scatter stable. a digit every key shares
+            // leaves the order unchanged, the offsets it already touched are rebuilt by the next digit
+            bool shared = false;
+            u32 sum = 0;
+            for (u32 digit = 0; digit < RADIX && !shared; digit++) {
+                u32 total = 0;
+                for (const auto& histogram : offsets) total += histogram[digit];
+                shared = total == count;
+                for (auto& histogram : offsets) {
+                    const u32 blockCount = histogram[digit];
+                    histogram[digit] = sum;
+                    sum += blockCount;
+                }
+            }
+            if (shared) continue;
+
+            jobs::parallelFor(blocks, 1, [&](u32 begin, u32 end) {
+                for (u32 block = begin; block < end; block++) {
+                    auto& next = offsets[block];
+                    for (u32 i = block * blockSize; i < std::min(count, (block + 1) * blockSize); i++)
+                        dst[next[(src[i].key >> shift) & (RADIX - 1)]++] = src[i];
+                }
+            });
+            std::swap(src, dst);
+        }
+        if (src != keys->data()) std::swap(*keys, *scratch);
+    }
+
+    // collects the surfaces of every instance at its selected lod, instance data must be uploaded already
+    void build(RendererState* state, f32 pixelsPerUnit) {
+        PROFILE_ZONE("draw build");
+        auto& draws = state->draws;
+        draws.commands.clear();
+        draws.keys.clear();
+        for (u32 index = 0; index < state->instances.size(); index++) {
+            const MeshInstance& instance = state->instances[index];
+            const MeshAsset& mesh = *instance.mesh;
+            const u32 lod = meshes::selectLod(mesh, instance.transform, state->camera.position, pixelsPerUnit);
+            const auto& surfaces = (lod == 0) ? mesh.surfaces : mesh.lods[lod - 1].surfaces;
+            const glm::vec3 center = glm::vec3(state->instanceBuffer.data[index].bounds);
+            const u32 depth = depthBucket(state->camera, glm::distance(center, state->camera.position));
+
+            for (usize i = 0; i < surfaces.size(); i++) {
+                if (surfaces[i].count == 0) continue;
+                const u32 material = materials::resolve(instance, surfaces[i]);
+                const u32 features = materials::get(state, material).features % MATERIAL_PERMUTATIONS;
+                const Pass pass = (features & MATERIAL_ALPHA_TEST) ? Pass::MASKED : Pass::OPAQUE;
+                draws.keys.push_back({ makeKey(pass, features, material, depth, mesh.id), (u32)draws.commands.size() });
+                draws.commands.push_back({
+                    .mesh = &mesh,
+                    .instance = index,
+                    .material = material,
+                    .startIndex = surfaces[i].startIndex,
+                    .count = surfaces[i].count,
+                    .trianglesSavedByLod = (mesh.surfaces[i].count - surfaces[i].count) / 3,
+                });
+            }
+        }
+        radixSort(&draws.keys, &draws.scratch);
+    }
+
+    // records the sorted draws, the frame wide push constants must already be pushed
+    void record(RendererState* state, VkCommandBuffer cmd, GPUDrawPushConstants* pushConstants) {
+        PROFILE_ZONE("draw record");
+        auto& stats = state->stats;
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        VkBuffer boundIndexBuffer = VK_NULL_HANDLE;
+        bool pushed = false;
+        for (const DrawKey& key : state->draws.keys) {
+            const DrawCommand& draw = state->draws.commands[key.draw];
+            const GPUMeshBuffers& buffers = draw.mesh->meshBuffers;
+
+            if (const VkPipeline pipeline = materials::pipeline(state, draw.material); pipeline != boundPipeline) {
+                vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+                boundPipeline = pipeline;
+                stats.pipelineBinds++;
+            }
+            if (buffers.indexBuffer.buffer != boundIndexBuffer) {
+                vkCmdBindIndexBuffer(cmd, buffers.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+                boundIndexBuffer = buffers.indexBuffer.buffer;
+                stats.indexBufferBinds++;
+            }
+
+            // vertex buffer, instance and material are adjacent, only the changed span is pushed
+            const bool vertexChanged = !pushed || pushConstants->vertexBuffer != buffers.vertexBufferAddress;
+            const bool instanceChanged = !pushed || pushConstants->instance != draw.instance;
+            const bool materialChanged = !pushed || pushConstants->material != draw.material;
+            if (vertexChanged || instanceChanged || materialChanged) {
+                pushConstants->vertexBuffer = buffers.vertexBufferAddress;
+                pushConstants->instance = draw.instance;
+                pushConstants->material = draw.material;
+                const u32 begin = vertexChanged ? offsetof(GPUDrawPushConstants, vertexBuffer)
+                    : instanceChanged ? offsetof(GPUDrawPushConstants, instance) : offsetof(GPUDrawPushConstants, material);
+                const u32 end = materialChanged ? offsetof(GPUDrawPushConstants, material) + sizeof(u32)
+                    : instanceChanged ? offsetof(GPUDrawPushConstants, instance) + sizeof(u32) : offsetof(GPUDrawPushConstants, instance);
+                vkCmdPushConstants(cmd, state->globalPipelineLayout, VK_SHADER_STAGE_ALL, begin, end - begin, (const u8*)pushConstants + begin);
+                stats.pushConstantUpdates++;
+                pushed = true;
+            }
+
+            vkCmdDrawIndexed(cmd, draw.count, 1, draw.startIndex, 0, 0);
+            stats.drawCount++;
+            stats.triangleCount += draw.count / 3;
+            stats.trianglesSavedByLod += draw.trianglesSavedByLod;
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+
+// gpu timestamp profiler. named scopes write a vkCmdWriteTimestamp2 pair into the current frame's
+// query pool, scopes nest and are identified by name + parent so the same pass always lands in the
+// same stats entry. results are read back FRAME_OVERLAP frames later once the frame's fence has
+// signalled, so reading never stalls. passes additionally record a pipeline statistics query when the
+// device supports it, next to the draws and dispatches recorded inside them
+namespace flux::renderer::gpuprofiler {
+
+    // result order follows bit order
+    static constexpr VkQueryPipelineStatisticFlags PIPELINE_STATISTICS =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+    static constexpr u32 PIPELINE_STATISTICS_COUNT = 6;
+
+    void init(RendererState* state) {
+        auto& profiler = state->gpuProfiler;
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(state->physicalDevice, &properties);
+        u32 familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(state->physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(state->physicalDevice, &familyCount, families.data());
+
+        const u32 validBits = families[state->queueFamily.graphics].timestampValidBits;
+        if (validBits == 0 || properties.limits.timestampPeriod == 0.f) {
+            log::warn("graphics queue does not support timestamps, gpu profiler disabled");
+            return;
+        }
+        profiler.timestampPeriod = properties.limits.timestampPeriod;
+        profiler.timestampMask = (validBits >= 64) ? std::numeric_limits<u64>::max() : (1ull << validBits) - 1;
+
+        VkQueryPoolCreateInfo poolInfo = {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = config::renderer::GPU_PROFILER_MAX_SCOPES * 2,
+        };
+        for (auto& pool : profiler.queryPools)
+            VK_CHECK(vkCreateQueryPool(state->device, &poolInfo, nullptr, &pool));
+        profiler.enabled = true;
+
+        // one statistics query per scope slot, only used by passes
+        if (profiler.pipelineStatistics) {
+            VkQueryPoolCreateInfo statisticsInfo = {
+                .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                .queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS,
+                .queryCount = config::renderer::GPU_PROFILER_MAX_SCOPES,
+                .pipelineStatistics = PIPELINE_STATISTICS,
+            };
+            for (auto& pool : profiler.statisticsPools)
+                VK_CHECK(vkCreateQueryPool(state->device, &statisticsInfo, nullptr, &pool));
+        }
+
+        state->deinitStack.emplace_back([state] {
+            for (auto& pool : state->gpuProfiler.queryPools)
+                vkDestroyQueryPool(state->device, pool, nullptr);
+            for (auto& pool : state->gpuProfiler.statisticsPools)
+                if (pool) vkDestroyQueryPool(state->device, pool, nullptr);
+        });
+    }
+
+    //---------------------------------------------------
+    // |>~ RECORDING ~<|
+    //---------------------------------------------------
+
+    // must be recorded before any scope of the frame, outside of rendering
+    void reset(RendererState* state, VkCommandBuffer cmd) {
+        auto& profiler = state->gpuProfiler;
+        if (!profiler.enabled) return;
+        const usize frame = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        vkCmdResetQueryPool(cmd, profiler.queryPools[frame], 0, config::renderer::GPU_PROFILER_MAX_SCOPES * 2);
+        if (profiler.pipelineStatistics)
+            vkCmdResetQueryPool(cmd, profiler.statisticsPools[frame], 0, config::renderer::GPU_PROFILER_MAX_SCOPES);
+        profiler.scopes[frame].clear();
+        profiler.open.clear();
+        profiler.statisticsActive = false;
+    }
+
+    u32 findStats(RendererState* state, const char* name, u32 parent) {
+        auto& stats = state->gpuProfiler.stats;
+        for (u32 i = 0; i < stats.size(); i++)
+            if (stats[i].parent == parent && std::string_view(stats[i].name) == name) return i;
+
+        const u32 depth = (parent == GpuScopeStats::ROOT) ? 0 : stats[parent].depth + 1;
+        stats.push_back({ .name = name, .parent = parent, .depth = depth });
+        return (u32)stats.size() - 1;
+    }
+
+    // name must outlive the profiler, string literals are expected
+    void begin(RendererState* state, VkCommandBuffer cmd, const char* name) {
+        auto& profiler = state->gpuProfiler;
+        if (!profiler.enabled) return;
+        const usize frame = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        auto& scopes = profiler.scopes[frame];
+        if (scopes.size() >= config::renderer::GPU_PROFILER_MAX_SCOPES) {
+            profiler.open.push_back(GpuScopeStats::ROOT); // keeps begin/end balanced
+            return;
+        }
+
+        const u32 parent = profiler.open.empty() || profiler.open.back() == GpuScopeStats::ROOT
+            ? GpuScopeStats::ROOT : scopes[profiler.open.back()].stat;
+        const u32 query = (u32)scopes.size() * 2;
+        scopes.push_back({ .stat = findStats(state, name, parent), .query = query });
+        profiler.open.push_back((u32)scopes.size() - 1);
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, profiler.queryPools[frame], query);
+    }
+
+    // a scope that also collects pipeline statistics, must begin and end outside of rendering.
+    // statistics queries cannot overlap, so passes nested in another pass only get timings
+    void beginPass(RendererState* state, VkCommandBuffer cmd, const char* name) {
+        auto& profiler = state->gpuProfiler;
+        begin(state, cmd, name);
+        if (!profiler.enabled || profiler.open.back() == GpuScopeStats::ROOT) return;
+
+        const usize frame = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        GpuScope& scope = profiler.scopes[frame][profiler.open.back()];
+        profiler.stats[scope.stat].pass = true;
+        scope.draws = state->stats.drawCount;
+        scope.dispatches = state->stats.dispatchCount;
+        if (profiler.pipelineStatistics && !profiler.statisticsActive) {
+            scope.statisticsQuery = profiler.open.back();
+            profiler.statisticsActive = true;
+            vkCmdBeginQuery(cmd, profiler.statisticsPools[frame], scope.statisticsQuery, 0);
+        }
+    }
+
+    void end(RendererState* state, VkCommandBuffer cmd) {
+        auto& profiler = state->gpuProfiler;
+        if (!profiler.enabled || profiler.open.empty()) return;
+        const u32 index = profiler.open.back();
+        profiler.open.pop_back();
+        if (index == GpuScopeStats::ROOT) return;
+
+        const usize frame = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        GpuScope& scope = profiler.scopes[frame][index];
+        vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, profiler.queryPools[frame], scope.query + 1);
+        if (profiler.stats[scope.stat].pass) {
+            scope.draws = state->stats.drawCount - scope.draws;
+            scope.dispatches = state->stats.dispatchCount - scope.dispatches;
+        }
+        if (scope.statisticsQuery != GpuScope::NO_QUERY) {
+            vkCmdEndQuery(cmd, profiler.statisticsPools[frame], scope.statisticsQuery);
+            profiler.statisticsActive = false;
+        }
+    }
+
+    // begin/end for a c++ scope
+    struct Scope {
+        RendererState* state;
+        VkCommandBuffer cmd;
+        Scope(RendererState* state, VkCommandBuffer cmd, const char* name) : state(state), cmd(cmd) { begin(state, cmd, name); }
+        ~Scope() { end(state, cmd); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    //---------------------------------------------------
+    // |>~ READBACK ~<|
+    //---------------------------------------------------
+
+    void addSample(GpuScopeStats& stats, f32 ms) {
+        stats.samples[stats.nextSample] = ms;
+        stats.nextSample = (stats.nextSample + 1) % config::renderer::GPU_PROFILER_HISTORY;
+        stats.sampleCount = std::min(stats.sampleCount + 1, config::renderer::GPU_PROFILER_HISTORY);
+        stats.last = ms;
+
+        std::array<f32, config::renderer::GPU_PROFILER_HISTORY> sorted;
+        std::copy_n(stats.samples.begin(), stats.sampleCount, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + stats.sampleCount);
+        f32 sum = 0.f;
+        for (u32 i = 0; i < stats.sampleCount; i++) sum += sorted[i];
+        stats.min = sorted[0];
+        stats.avg = sum / (f32)stats.sampleCount;
+        stats.p99 = sorted[std::min(stats.sampleCount - 1, (u32)std::ceil((f32)stats.sampleCount * 0.99f) - 1)];
+    }
+
+    // reads the queries of the frame about to be recorded, its fence must already have been waited on.
+    // the scopes are consumed so a skipped frame does not report the same results twice
+    void collect(RendererState* state) {
+        auto& profiler = state->gpuProfiler;
+        if (!profiler.enabled) return;
+        const usize frame = state->frameNumber % config::renderer::FRAME_OVERLAP;
+        auto& scopes = profiler.scopes[frame];
+        if (scopes.empty()) return;
+
+        std::array<u64, config::renderer::GPU_PROFILER_MAX_SCOPES * 2> timestamps;
+        const VkResult result = vkGetQueryPoolResults(state->device, profiler.queryPools[frame], 0, (u32)scopes.size() * 2,
+            scopes.size() * 2 * sizeof(u64), timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+        if (result != VK_SUCCESS) {
+            scopes.clear();
+            return;
+        }
+
+        for (const auto& scope : scopes) {
+            const u64 ticks = (timestamps[scope.query + 1] - timestamps[scope.query]) & profiler.timestampMask;
+            addSample(profiler.stats[scope.stat], (f32)((f64)ticks * profiler.timestampPeriod * 1e-6));
+        }
+
+        // pass counters, statistics only where the pass owned a query
+        std::array<u64, PIPELINE_STATISTICS_COUNT> statistics;
+        for (const auto& scope : scopes) {
+            auto& stats = profiler.stats[scope.stat];
+            if (!stats.pass) continue;
+            stats.counters = { .draws = scope.draws, .dispatches = scope.dispatches };
+            if (scope.statisticsQuery == GpuScope::NO_QUERY) continue;
+            if (vkGetQueryPoolResults(state->device, profiler.statisticsPools[frame], scope.statisticsQuery, 1,
+                sizeof(statistics), statistics.data(), sizeof(statistics), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) continue;
+            stats.counters.inputPrimitives = statistics[0];
+            stats.counters.vertexInvocations = statistics[1];
+            stats.counters.clippingInvocations = statistics[2];
+            stats.counters.clippingPrimitives = statistics[3];
+            stats.counters.fragmentInvocations = statistics[4];
+            stats.counters.computeInvocations = statistics[5];
+        }
+        scopes.clear();
+    }
+}
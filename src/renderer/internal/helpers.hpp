@@ -15,11 +15,24 @@ namespace flux::renderer {
         return state->frames[state->frameNumber % config::renderer::FRAME_OVERLAP];
     };
 
+    inline glm::mat4 getViewProjection(const RendererState* state) {
+        const Camera& camera = state->camera;
+        const glm::mat4 rotation =
+            glm::rotate(glm::mat4(1.f), camera.yaw, { 0.f, -1.f, 0.f }) *
+            glm::rotate(glm::mat4(1.f), camera.pitch, { 1.f, 0.f, 0.f });
+        const glm::mat4 view = glm::inverse(glm::translate(glm::mat4(1.f), camera.position) * rotation);
+        const f32 aspect = (f32)state->drawExtent.width / (f32)std::max(state->drawExtent.height, 1u);
+        glm::mat4 projection = glm::perspective(camera.fovY, aspect, camera.nearPlane, camera.farPlane);
+        projection[1][1] *= -1; // vulkan clip space has y pointing down
+        return projection * view;
+    }
+
 }
 
 namespace flux::renderer::vkutil {
 
     void immediateSubmit(RendererState* state, std::function<void(VkCommandBuffer cmd)>&& fn) {
+        PROFILE_ZONE("immediate submit");
         VK_CHECK(vkResetFences(state->device, 1, &state->immediateSubmit.fence));
         VK_CHECK(vkResetCommandBuffer(state->immediateSubmit.cmdBuffer, 0));
 
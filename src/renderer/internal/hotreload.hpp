@@ -0,0 +1,191 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "shaders.hpp"
+#include "deletion.hpp"
+#include <core/engine.hpp>
+
+#if defined(__linux__)
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+// shader hot reload. res/shaders is watched with inotify, a changed .slang file is recompiled with
+// slangc on a job worker and every tracked pipeline using it is rebuilt from the new spir-v. pipelines
+// are only swapped in poll, which runs at the frame boundary, the old pipeline is retired through the
+// deletion queue. a failed compile or pipeline build keeps the old pipeline. only the changed file is
+// recompiled, shaders importing it pick the change up on their own next edit
+namespace flux::renderer::hotreload {
+
+    std::filesystem::path spirvPath(const std::string& shader) {
+        return config::renderer::SHADER_OUTPUT_DIR / (shader + ".spv");
+    }
+
+    // loads, reflects and validates the shaders, then builds and swaps the pipeline. the previous one is retired
+    bool rebuild(RendererState* state, RendererState::ReloadablePipeline& tracked) {
+        std::vector<VkShaderModule> modules(tracked.shaders.size(), VK_NULL_HANDLE);
+        std::vector<ShaderReflection> reflections(tracked.shaders.size());
+        bool valid = true;
+        for (usize i = 0; i < tracked.shaders.size(); i++) {
+            const std::string& name = tracked.shaders[i];
+            if (!vkutil::loadShaderModule(spirvPath(name).string().c_str(), state->device, &modules[i], &reflections[i])) {
+                log::warn(std::format("failed to load shader module {}", name));
+                valid = false;
+                continue;
+            }
+            valid &= reflection::validateDescriptors(reflections[i], name);
+            valid &= reflection::validatePushConstants(reflections[i], name, tracked.pushConstants);
+        }
+        const VkPipeline pipeline = valid ? tracked.build(modules, reflections) : VK_NULL_HANDLE;
+        for (auto module : modules)
+            if (module) vkDestroyShaderModule(state->device, module, nullptr);
+        if (!pipeline) return false;
+
+        if (*tracked.pipeline) deletion::retirePipeline(state, *tracked.pipeline);
+        *tracked.pipeline = pipeline;
+        tracked.reflections = std::move(reflections);
+        return true;
+    }
+
+    // builds the pipeline from compiled shaders (names without extension, e.g. "mesh.vert") and keeps
+    // rebuilding it when one of them changes. build receives modules and reflections in the order of shaders.
+    // the shaders' push constant blocks are checked against pushConstants
+    void buildPipeline(RendererState* state, VkPipeline* pipeline, std::vector<std::string> shaders, const PushConstantLayout& pushConstants,
+        std::function<VkPipeline(std::span<const VkShaderModule> modules, std::span<const ShaderReflection> reflections)>&& build) {
+        RendererState::ReloadablePipeline tracked = {
+            .pipeline = pipeline,
+            .shaders = std::move(shaders),
+            .pushConstants = pushConstants,
+            .build = std::move(build),
+        };
+        if (!rebuild(state, tracked))
+            log::warn(std::format("failed to build pipeline from {}", tracked.shaders.front()));
+        if (state->shaderReload.enabled)
+            state->shaderReload.pipelines.push_back(std::move(tracked));
+    }
+
+    void init(RendererState* state) {
+        auto& reload = state->shaderReload;
+        if (!config::renderer::ENABLE_SHADER_HOT_RELOAD || state->engine->options.headless) return;
+#if defined(__linux__)
+        reload.inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (reload.inotify < 0 || inotify_add_watch(reload.inotify, config::renderer::SHADER_SOURCE_DIR.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            log::warn(std::format("failed to watch {}, shader hot reload disabled", config::renderer::SHADER_SOURCE_DIR.string()));
+            if (reload.inotify >= 0) close(reload.inotify);
+            reload.inotify = -1;
+            return;
+        }
+        reload.enabled = true;
+        log::debug(std::format("watching {} for shader changes", config::renderer::SHADER_SOURCE_DIR.string()));
+#else
+        log::debug("shader hot reload is only supported on linux");
+        return;
+#endif
+
+        state->deinitStack.emplace_back([state] {
+            auto& reload = state->shaderReload;
+            for (auto& compile : reload.compiles)
+                jobs::wait(&compile->done);
+            reload.compiles.clear();
+            reload.pipelines.clear();
+#if defined(__linux__)
+            close(reload.inotify);
+#endif
+        });
+    }
+
+    //---------------------------------------------------
+    // |>~ COMPILING ~<|
+    //---------------------------------------------------
+
+    // runs on a job worker. writes to a temporary file first so a failed compile never replaces the
+    // spir-v the running pipelines were built from
+    void runCompiler(RendererState::ShaderCompile* compile) {
+        const auto source = config::renderer::SHADER_SOURCE_DIR / (compile->shader + ".slang");
+        const auto output = spirvPath(compile->shader);
+        auto temporary = output;
+        temporary += ".tmp";
+        const auto command = std::format("{} -target spirv -fvk-use-entrypoint-name -fvk-use-scalar-layout -o \"{}\" \"{}\" 2>&1",
+            config::renderer::SHADER_COMPILER, temporary.string(), source.string());
+
+        FILE* pipe = popen(command.c_str(), "r");
+        if (!pipe) {
+            compile->output = std::format("failed to run {}", config::renderer::SHADER_COMPILER);
+            return;
+        }
+        std::array<char, 256> chunk;
+        usize read = 0;
+        while ((read = std::fread(chunk.data(), 1, chunk.size(), pipe)) > 0)
+            compile->output.append(chunk.data(), read);
+        const bool exited = pclose(pipe) == 0;
+
+        std::error_code error;
+        if (exited) std::filesystem::rename(temporary, output, error);
+        else std::filesystem::remove(temporary, error);
+        compile->succeeded = exited && !error;
+        if (exited && error) compile->output += error.message();
+    }
+
+    void schedule(RendererState* state, std::string shader) {
+        auto& compiles = state->shaderReload.compiles;
+        // editors often write a file several times in a row, a compile already in flight runs again once done
+        for (auto& running : compiles) {
+            if (running->shader != shader) continue;
+            running->again = true;
+            return;
+        }
+        log::debug(std::format("recompiling {}", shader));
+        auto& compile = compiles.emplace_back(std::make_unique<RendererState::ShaderCompile>());
+        compile->shader = std::move(shader);
+        jobs::run(&compile->done, [target = compile.get()] { runCompiler(target); });
+    }
+
+    void finish(RendererState* state, const RendererState::ShaderCompile& compile) {
+        if (!compile.succeeded) {
+            log::warn(std::format("failed to compile {}, keeping the old pipelines:\n{}", compile.shader, compile.output));
+            return;
+        }
+        u32 rebuilt = 0, failed = 0;
+        for (auto& tracked : state->shaderReload.pipelines) {
+            if (std::find(tracked.shaders.begin(), tracked.shaders.end(), compile.shader) == tracked.shaders.end()) continue;
+            if (rebuild(state, tracked)) rebuilt++;
+            else failed++;
+        }
+        if (failed > 0) log::warn(std::format("{}: {} pipelines failed to build, keeping the old ones", compile.shader, failed));
+        log::debug(std::format("reloaded {}, {} pipelines rebuilt", compile.shader, rebuilt));
+    }
+
+    // at the frame boundary, before recording. picks up file changes and swaps in finished pipelines
+    void poll(RendererState* state) {
+        auto& reload = state->shaderReload;
+        if (!reload.enabled) return;
+        PROFILE_ZONE("shader reload");
+
+#if defined(__linux__)
+        std::array<char, 4096> events;
+        i64 length = 0;
+        while ((length = read(reload.inotify, events.data(), events.size())) > 0) {
+            for (i64 offset = 0; offset < length;) {
+                // the fixed header is copied out, the name follows it in the buffer and is nul padded
+                inotify_event event;
+                std::memcpy(&event, events.data() + offset, sizeof(inotify_event));
+                const char* eventName = events.data() + offset + sizeof(inotify_event);
+                offset += (i64)(sizeof(inotify_event) + event.len);
+                const std::string_view name = (event.len > 0) ? std::string_view(eventName) : std::string_view();
+                if (name.ends_with(".slang"))
+                    schedule(state, std::string(name.substr(0, name.size() - std::string_view(".slang").size())));
+            }
+        }
+#endif
+
+        std::vector<std::string> again;
+        std::erase_if(reload.compiles, [&](const std::unique_ptr<RendererState::ShaderCompile>& compile) {
+            if (compile->done.pending.load(std::memory_order_acquire) != 0) return false;
+            finish(state, *compile);
+            if (compile->again) again.push_back(compile->shader);
+            return true;
+        });
+        for (auto& shader : again)
+            schedule(state, std::move(shader));
+    }
+}
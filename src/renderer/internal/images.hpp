@@ -11,21 +11,32 @@ namespace flux::renderer::vkres {
         VK_IMAGE_USAGE_STORAGE_BIT |
         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+    // depth attachment of the geometry pass, sized like the draw image
+    static constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+    static constexpr VkImageUsageFlags DEPTH_IMAGE_USES = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
     static constexpr VkImageUsageFlags COMBINED_SAMPLER_USES =
         VK_IMAGE_USAGE_SAMPLED_BIT |
         VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 
+    // sampled images uploaded from the cpu, transfer src is needed for blitting mips
+    static constexpr VkImageUsageFlags TEXTURE_USES =
+        VK_IMAGE_USAGE_SAMPLED_BIT |
+        VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+        VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
     AllocatedImage createImage(VmaAllocator allocator, VkExtent3D size, VkFormat format, VkImageUsageFlags usage, bool mipmapped = false) {
         AllocatedImage result = {
             .extent = size,
             .format = format,
+            .mipLevels = (mipmapped) ? static_cast<u32>(std::floor(std::log2(std::max(size.width, size.height)))) + 1 : 1,
         };
         VkImageCreateInfo info = {
             .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
             .imageType = VK_IMAGE_TYPE_2D,
             .format = result.format,
             .extent = result.extent,
-            .mipLevels = (mipmapped) ? static_cast<u32>(std::floor(std::log2(std::max(size.width, size.height)))) + 1 : 1,
+            .mipLevels = result.mipLevels,
             .arrayLayers = 1,
             .samples = VK_SAMPLE_COUNT_1_BIT, // for MSAA, default to 1 sample ppx
             .tiling = VK_IMAGE_TILING_OPTIMAL, // OPTIMAL for smallest size on gpu, LINEAR for cpu readback
@@ -43,7 +54,7 @@ namespace flux::renderer::vkres {
         vmaDestroyImage(allocator, image.image, image.allocation);
     }
 
-    VkImageView createImageView(RendererState* state, const AllocatedImage& img) {
+    VkImageView createImageView(RendererState* state, const AllocatedImage& img, VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT) {
         VkImageView result = nullptr;
         VkImageViewCreateInfo info = {
             .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -51,9 +62,9 @@ namespace flux::renderer::vkres {
             .viewType = VK_IMAGE_VIEW_TYPE_2D,
             .format = img.format,
             .subresourceRange = {
-                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .aspectMask = aspect,
                 .baseMipLevel = 0,
-                .levelCount = 1,
+                .levelCount = img.mipLevels,
                 .baseArrayLayer = 0,
                 .layerCount = 1,
             },
@@ -62,7 +73,7 @@ namespace flux::renderer::vkres {
         return result;
     }
 
-    VkSampler createSampler(RendererState* state, const AllocatedImage& img) {
+    VkSampler createSampler(RendererState* state, f32 maxLod = VK_LOD_CLAMP_NONE) {
         VkSampler result = nullptr;
         VkSamplerCreateInfo info = {
             .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
@@ -78,7 +89,7 @@ namespace flux::renderer::vkres {
             .compareEnable = VK_FALSE,
             .compareOp = VK_COMPARE_OP_ALWAYS,
             .minLod = 0.0f,
-            .maxLod = 0.0f,
+            .maxLod = maxLod,
             .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_BLACK,
         };
         VK_CHECK(vkCreateSampler(state->device, &info, nullptr, &result));
@@ -153,6 +164,74 @@ namespace flux::renderer::vkutil {
         vkCmdBlitImage2(cmd, &blitInfo);
     }
 
+    // fills mips 1..n by successive blits from mip 0, expects all mips in TRANSFER_DST_OPTIMAL
+    // and leaves the image in SHADER_READ_ONLY_OPTIMAL
+    void generateMipmaps(VkCommandBuffer cmd, VkImage image, VkExtent2D imageSize, u32 mipLevels) {
+        for (u32 mip = 0; mip < mipLevels; mip++) {
+            VkImageMemoryBarrier2 imageBarrier = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .dstAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_MEMORY_READ_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                .image = image,
+                .subresourceRange = {
+                    .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                    .baseMipLevel = mip,
+                    .levelCount = 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1,
+                },
+            };
+            VkDependencyInfo depInfo = {
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount = 1,
+                .pImageMemoryBarriers = &imageBarrier,
+            };
+            vkCmdPipelineBarrier2(cmd, &depInfo);
+
+            if (mip + 1 < mipLevels) {
+                const VkExtent2D halfSize = {
+                    std::max(imageSize.width / 2, 1u),
+                    std::max(imageSize.height / 2, 1u),
+                };
+                VkImageBlit2 blitRegion = {
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+                    .srcSubresource = {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = mip,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1,
+                    },
+                    .dstSubresource = {
+                        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                        .mipLevel = mip + 1,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1,
+                    },
+                };
+                blitRegion.srcOffsets[1] = { (i32)imageSize.width, (i32)imageSize.height, 1 };
+                blitRegion.dstOffsets[1] = { (i32)halfSize.width, (i32)halfSize.height, 1 };
+                VkBlitImageInfo2 blitInfo = {
+                    .sType = VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+                    .srcImage = image,
+                    .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .dstImage = image,
+                    .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .regionCount = 1,
+                    .pRegions = &blitRegion,
+                    .filter = VK_FILTER_LINEAR,
+                };
+                vkCmdBlitImage2(cmd, &blitInfo);
+                imageSize = halfSize;
+            }
+        }
+        // every mip now sits in TRANSFER_SRC_OPTIMAL
+        transitionImage(cmd, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
     void insertImageMemoryBarrier(
 			VkCommandBuffer cmd,
 			VkImage image,
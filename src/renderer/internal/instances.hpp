@@ -0,0 +1,95 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "buffers.hpp"
+
+// gpu resident instance data. every MeshInstance owns the GPUInstance at its index in a device local
+// buffer that shaders read through buffer device address. changes only mark the instance dirty, once per
+// frame the dirty instances are coalesced into ranges and copied from a staging buffer, so a static scene
+// costs no upload bandwidth. previous transforms are kept for motion vectors: an instance whose transform
+// was set is uploaded once more the frame after, when its previous transform catches up
+namespace flux::renderer::instances {
+
+    GPUInstance toGpu(const MeshInstance& instance) {
+        const glm::vec4 bounds = instance.mesh ? instance.mesh->bounds : glm::vec4(0.f);
+        const f32 scale = std::max({
+            glm::length(glm::vec3(instance.transform[0])),
+            glm::length(glm::vec3(instance.transform[1])),
+            glm::length(glm::vec3(instance.transform[2])),
+        });
+        return {
+            .transform = instance.transform,
+            .previousTransform = instance.transform,
+            .bounds = glm::vec4(glm::vec3(instance.transform * glm::vec4(glm::vec3(bounds), 1.f)), bounds.w * scale),
+            .material = instance.material,  // NO_MATERIAL without an override, surfaces bring their own
+        };
+    }
+
+    void markDirty(RendererState* state, u32 index) {
+        state->instanceBuffer.dirty.push_back(index);
+    }
+
+    u32 add(RendererState* state, MeshInstance instance) {
+        const u32 index = (u32)state->instances.size();
+        state->instances.push_back(std::move(instance));
+        state->instanceBuffer.data.push_back(toGpu(state->instances.back()));
+        markDirty(state, index);
+        return index;
+    }
+
+    void setTransform(RendererState* state, u32 index, const glm::mat4& transform) {
+        state->instances[index].transform = transform;
+        state->instanceBuffer.moving.push_back(index);
+        markDirty(state, index);
+    }
+
+    void setMaterial(RendererState* state, u32 index, u32 material) {
+        state->instances[index].material = material;
+        markDirty(state, index);
+    }
+
+    // takes over instances placed directly into state->instances, e.g. by the scene loaders
+    void init(RendererState* state) {
+        auto& buffer = state->instanceBuffer;
+        buffer.data.clear();
+        buffer.data.reserve(state->instances.size());
+        for (u32 i = 0; i < state->instances.size(); i++) {
+            buffer.data.push_back(toGpu(state->instances[i]));
+            markDirty(state, i);
+        }
+        state->deinitStack.emplace_back([state] {
+            vkres::destroyResident(state, &state->instanceBuffer.buffer);
+            state->instanceBuffer = {};
+        });
+    }
+
+    // applies the dirty instances to data and returns the ranges to upload. instances that moved last
+    // frame are included so their previous transform catches up
+    std::vector<vkres::Range> collect(RendererState* state) {
+        auto& buffer = state->instanceBuffer;
+        buffer.dirty.insert(buffer.dirty.end(), buffer.moved.begin(), buffer.moved.end());
+        std::swap(buffer.moved, buffer.moving);
+        buffer.moving.clear();
+        if (buffer.dirty.empty()) return {};
+
+        auto ranges = vkres::dirtyRanges(&buffer.dirty, config::renderer::INSTANCE_UPLOAD_MERGE_GAP);
+        for (u32 index : buffer.dirty) {
+            GPUInstance& gpu = buffer.data[index];
+            const glm::mat4 previous = gpu.transform;
+            gpu = toGpu(state->instances[index]);
+            gpu.previousTransform = previous;
+        }
+        buffer.dirty.clear();
+        return ranges;
+    }
+
+    // uploads the dirty ranges, recorded before anything reads instances this frame
+    void record(RendererState* state, VkCommandBuffer cmd) {
+        PROFILE_ZONE("instance upload");
+        auto& buffer = state->instanceBuffer;
+        const auto ranges = collect(state);
+        buffer.uploadedInstances = vkres::upload(state, cmd, &buffer.buffer, buffer.data.data(), sizeof(GPUInstance), buffer.data.size(), ranges,
+            VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            config::renderer::INSTANCE_BUFFER_MIN_CAPACITY * sizeof(GPUInstance));
+    }
+}
@@ -2,35 +2,663 @@
 #include "../renderer.hpp"
 #include "helpers.hpp"
 #include "vkstructs.hpp"
+#include "buffers.hpp"
+#include "meshes.hpp"
+#include "textures.hpp"
+
+#include <subsystems/jobs.hpp>
 
-#include <stb/stb_image.h>
 #include <fastgltf/core.hpp>
 #include <fastgltf/glm_element_traits.hpp>
 #include <fastgltf/tools.hpp>
 
 namespace flux::renderer::vkutil {
 
-    std::optional<std::vector<std::shared_ptr<MeshAsset>>> loadGltfMeshes(RendererState* state, std::filesystem::path filePath) {
-        log::debug(std::format("loading gltf: {}", filePath));
+    std::optional<fastgltf::Asset> parseGltf(const std::filesystem::path& filePath) {
+        auto data = fastgltf::GltfDataBuffer::FromPath(filePath);
+        if (data.error() != fastgltf::Error::None) {
+            log::warn(std::format("failed to read gltf: {}", fastgltf::getErrorMessage(data.error())));
+            return {};
+        }
 
-        fastgltf::GltfDataBuffer data;
-        data.FromPath(filePath);
+        fastgltf::Parser parser {};
+        auto load = parser.loadGltf(data.get(), filePath.parent_path(), fastgltf::Options::LoadExternalBuffers);
+        if (load.error() != fastgltf::Error::None) {
+            log::warn(std::format("failed to load gltf: {}", fastgltf::getErrorMessage(load.error())));
+            return {};
+        }
+        return std::move(load.get());
+    }
 
-        constexpr auto gltfOptions =
-            fastgltf::Options::LoadGLBBuffers |
-            fastgltf::Options::LoadExternalBuffers;
+    std::optional<std::vector<meshes::MeshData>> importGltfMeshes(const std::filesystem::path& filePath) {
+        log::debug(std::format("importing gltf: {}", filePath.string()));
 
-        fastgltf::Asset gltf;
-        fastgltf::Parser parser {};
+        auto asset = parseGltf(filePath);
+        if (!asset.has_value()) return {};
+        fastgltf::Asset& gltf = asset.value();
+
+        std::vector<meshes::MeshData> result;
+        result.reserve(gltf.meshes.size());
+        for (fastgltf::Mesh& mesh : gltf.meshes) {
+            meshes::MeshData& newMesh = result.emplace_back();
+            newMesh.name = mesh.name.c_str();
+
+            for (auto&& p : mesh.primitives) {
+                auto positions = p.findAttribute("POSITION");
+                if (p.type != fastgltf::PrimitiveType::Triangles || !p.indicesAccessor.has_value() || positions == p.attributes.end()) {
+                    log::warn(std::format("skipping non indexed triangle primitive in mesh: {}", newMesh.name));
+                    continue;
+                }
+
+                // matches the order readGltfMaterials returns materials in
+                const u32 material = p.materialIndex.has_value() ? (u32)p.materialIndex.value() : NO_MATERIAL;
+
+                auto& indexAccessor = gltf.accessors[p.indicesAccessor.value()];
+                newMesh.surfaces.push_back({
+                    .startIndex = (u32)newMesh.indices.size(),
+                    .count = (u32)indexAccessor.count,
+                    .material = material,
+                });
+                const u32 initialVertex = (u32)newMesh.vertices.size();
+
+                // indices
+                newMesh.indices.reserve(newMesh.indices.size() + indexAccessor.count);
+                fastgltf::iterateAccessor<u32>(gltf, indexAccessor, [&](u32 idx) {
+                    newMesh.indices.push_back(idx + initialVertex);
+                });
+
+                // vertex positions
+                auto& posAccessor = gltf.accessors[positions->accessorIndex];
+                newMesh.vertices.resize(newMesh.vertices.size() + posAccessor.count);
+                fastgltf::iterateAccessorWithIndex<glm::vec3>(gltf, posAccessor, [&](glm::vec3 v, usize index) {
+                    newMesh.vertices[initialVertex + index] = {
+                        .position = v,
+                        .uv_x = 0.f,
+                        .normal = { 1.f, 0.f, 0.f },
+                        .uv_y = 0.f,
+                        .color = glm::vec4 { 1.f },
+                    };
+                });
+
+                // vertex normals
+                if (auto normals = p.findAttribute("NORMAL"); normals != p.attributes.end()) {
+                    fastgltf::iterateAccessorWithIndex<glm::vec3>(gltf, gltf.accessors[normals->accessorIndex], [&](glm::vec3 v, usize index) {
+                        newMesh.vertices[initialVertex + index].normal = v;
+                    });
+                }
+
+                // uvs
+                if (auto uv = p.findAttribute("TEXCOORD_0"); uv != p.attributes.end()) {
+                    fastgltf::iterateAccessorWithIndex<glm::vec2>(gltf, gltf.accessors[uv->accessorIndex], [&](glm::vec2 v, usize index) {
+                        newMesh.vertices[initialVertex + index].uv_x = v.x;
+                        newMesh.vertices[initialVertex + index].uv_y = v.y;
+                    });
+                }
+
+                // vertex colors
+                if (auto colors = p.findAttribute("COLOR_0"); colors != p.attributes.end()) {
+                    fastgltf::iterateAccessorWithIndex<glm::vec4>(gltf, gltf.accessors[colors->accessorIndex], [&](glm::vec4 v, usize index) {
+                        newMesh.vertices[initialVertex + index].color = v;
+                    });
+                }
+            }
+        }
+        return result;
+    }
+
+    // cooked packs are reused while they are at least as new as every file they were cooked from
+    bool isPackFresh(const std::filesystem::path& packPath, std::span<const std::filesystem::path> sourcePaths) {
+        std::error_code ec;
+        if (!std::filesystem::exists(packPath, ec)) return false;
+        const auto packTime = std::filesystem::last_write_time(packPath, ec);
+        return std::all_of(sourcePaths.begin(), sourcePaths.end(), [&](const std::filesystem::path& sourcePath) {
+            return packTime >= std::filesystem::last_write_time(sourcePath, ec);
+        });
+    }
+
+    bool isPackFresh(const std::filesystem::path& packPath, const std::filesystem::path& sourcePath) {
+        return isPackFresh(packPath, std::span<const std::filesystem::path>(&sourcePath, 1));
+    }
+
+    //---------------------------------------------------
+    // |>~ MESH PACKS ~<|
+    //---------------------------------------------------
+    // layout: MeshPackHeader, then per mesh a MeshPackEntry followed by name bytes, surfaces,
+    // per lod its error and surfaces, encoded vertex data and encoded index data
+
+    static constexpr u32 MESH_PACK_MAGIC = 0x504d5846; // "FXMP"
+    static constexpr u32 MESH_PACK_VERSION = 4;
+
+    struct MeshPackHeader {
+        u32 magic;
+        u32 version;
+        u32 meshCount;
+    };
+
+    struct MeshPackEntry {
+        glm::vec4 bounds;
+        u32 nameSize;
+        u32 surfaceCount;
+        u32 lodCount;
+        u32 vertexCount;
+        u32 indexCount;
+        u32 vertexDataSize;
+        u32 indexDataSize;
+    };
+
+    bool writeMeshPack(const std::filesystem::path& filePath, std::span<const meshes::EncodedMesh> encoded) {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
 
-        auto load = parser.loadGltfBinary(data, filePath.parent_path(), gltfOptions);
-        if (load) {
-            gltf = std::move(load.get());
-        } else {
-            log::warn(std::format("Failed to load glTF: {} \n", fastgltf::to_underlying(load.error())));
+        MeshPackHeader header = { MESH_PACK_MAGIC, MESH_PACK_VERSION, (u32)encoded.size() };
+        file.write((const char*)&header, sizeof(header));
+        for (auto& mesh : encoded) {
+            MeshPackEntry entry = {
+                .bounds = mesh.bounds,
+                .nameSize = (u32)mesh.name.size(),
+                .surfaceCount = (u32)mesh.surfaces.size(),
+                .lodCount = (u32)mesh.lods.size(),
+                .vertexCount = mesh.vertexCount,
+                .indexCount = mesh.indexCount,
+                .vertexDataSize = (u32)mesh.vertexData.size(),
+                .indexDataSize = (u32)mesh.indexData.size(),
+            };
+            file.write((const char*)&entry, sizeof(entry));
+            file.write(mesh.name.data(), (i64)mesh.name.size());
+            file.write((const char*)mesh.surfaces.data(), (i64)(mesh.surfaces.size() * sizeof(GeoSurface)));
+            for (auto& lod : mesh.lods) {
+                file.write((const char*)&lod.error, sizeof(lod.error));
+                file.write((const char*)lod.surfaces.data(), (i64)(lod.surfaces.size() * sizeof(GeoSurface)));
+            }
+            file.write((const char*)mesh.vertexData.data(), (i64)mesh.vertexData.size());
+            file.write((const char*)mesh.indexData.data(), (i64)mesh.indexData.size());
+        }
+        return file.good();
+    }
+
+    // meshopt spends at least a control byte per 4 vertex bytes of a 256 vertex block and a byte per
+    // triangle plus its header and tail, so counts past these came from a stale or corrupt pack
+    static constexpr u64 MAX_VERTEX_EXPANSION = 1024;
+
+    bool countsFitEncoding(const MeshPackEntry& entry) {
+        return (u64)entry.vertexCount * sizeof(PackedVertex) <= (u64)entry.vertexDataSize * MAX_VERTEX_EXPANSION
+            && entry.indexCount % 3 == 0 && (u64)entry.indexCount / 3 + 17 <= entry.indexDataSize;
+    }
+
+    bool surfacesFit(std::span<const GeoSurface> surfaces, u32 indexCount) {
+        return std::all_of(surfaces.begin(), surfaces.end(),
+            [&](const GeoSurface& surface) { return (u64)surface.startIndex + surface.count <= indexCount; });
+    }
+
+    // fails on anything that does not decode into in range draws, the caller cooks the pack again
+    std::optional<std::vector<meshes::EncodedMesh>> readMeshPack(const std::filesystem::path& filePath) {
+        auto file = utility::readFile(filePath);
+        if (!file.has_value()) return {};
+        const std::vector<u8>& bytes = file.value();
+
+        usize offset = 0;
+        auto read = [&](void* dst, usize size) {
+            if (offset + size > bytes.size()) return false;
+            memcpy(dst, bytes.data() + offset, size);
+            offset += size;
+            return true;
+        };
+
+        MeshPackHeader header = {};
+        if (!read(&header, sizeof(header)) || header.magic != MESH_PACK_MAGIC || header.version != MESH_PACK_VERSION)
             return {};
+        if (header.meshCount > (bytes.size() - offset) / sizeof(MeshPackEntry))
+            return {};
+
+        std::vector<meshes::EncodedMesh> result(header.meshCount);
+        for (auto& mesh : result) {
+            MeshPackEntry entry = {};
+            if (!read(&entry, sizeof(entry))) return {};
+            const usize lodSize = sizeof(f32) + (usize)entry.surfaceCount * sizeof(GeoSurface);
+            const usize payloadSize = (usize)entry.nameSize + (usize)entry.surfaceCount * sizeof(GeoSurface) +
+                (usize)entry.lodCount * lodSize + (usize)entry.vertexDataSize + (usize)entry.indexDataSize;
+            if (payloadSize > bytes.size() - offset || !countsFitEncoding(entry)) return {};
+            mesh.bounds = entry.bounds;
+            mesh.name.resize(entry.nameSize);
+            mesh.surfaces.resize(entry.surfaceCount);
+            mesh.lods.resize(entry.lodCount);
+            mesh.vertexCount = entry.vertexCount;
+            mesh.indexCount = entry.indexCount;
+            mesh.vertexData.resize(entry.vertexDataSize);
+            mesh.indexData.resize(entry.indexDataSize);
+            if (!read(mesh.name.data(), mesh.name.size()) ||
+                !read(mesh.surfaces.data(), mesh.surfaces.size() * sizeof(GeoSurface)) ||
+                !surfacesFit(mesh.surfaces, entry.indexCount))
+                return {};
+            for (auto& lod : mesh.lods) {
+                lod.surfaces.resize(entry.surfaceCount);
+                if (!read(&lod.error, sizeof(lod.error)) ||
+                    !read(lod.surfaces.data(), lod.surfaces.size() * sizeof(GeoSurface)) ||
+                    !surfacesFit(lod.surfaces, entry.indexCount))
+                    return {};
+            }
+            if (!read(mesh.vertexData.data(), mesh.vertexData.size()) ||
+                !read(mesh.indexData.data(), mesh.indexData.size()))
+                return {};
         }
+        return result;
+    }
+
+    // imports a gltf and cooks it into a mesh pack next to the source file
+    std::optional<std::vector<meshes::EncodedMesh>> cookGltfMeshes(const std::filesystem::path& filePath, const std::filesystem::path& packPath) {
+        auto imported = importGltfMeshes(filePath);
+        if (!imported.has_value()) return {};
+
+        usize rawSize = 0, packedSize = 0;
+        for (auto& mesh : *imported)
+            rawSize += mesh.vertices.size() * sizeof(Vertex) + mesh.indices.size() * sizeof(u32);
 
+        std::vector<meshes::EncodedMesh> encoded(imported->size());
+        std::vector<meshes::OptimizeStats> stats(imported->size());
+        jobs::parallelFor((u32)encoded.size(), 1, [&](u32 begin, u32 end) {
+            for (u32 i = begin; i < end; i++) {
+                auto& mesh = (*imported)[i];
+                mesh.bounds = meshes::computeBounds(mesh.vertices);
+                meshes::buildLods(mesh);
+                stats[i] = meshes::optimize(mesh);
+                encoded[i] = meshes::encode(mesh);
+            }
+        });
+
+        for (usize i = 0; i < stats.size(); i++) {
+            log::debug(std::format("optimized mesh {}: acmr {:.3f} -> {:.3f}, atvr {:.3f} -> {:.3f}", (*imported)[i].name,
+                stats[i].before.acmr, stats[i].after.acmr, stats[i].before.atvr, stats[i].after.atvr));
+        }
+
+        for (auto& mesh : encoded)
+            packedSize += mesh.vertexData.size() + mesh.indexData.size();
+        log::debug(std::format("cooked {} meshes: {} -> {} bytes", encoded.size(), rawSize, packedSize));
+
+        if (!writeMeshPack(packPath, encoded))
+            log::warn(std::format("failed to write mesh pack: {}", packPath.string()));
+        return encoded;
+    }
+
+    // loads meshes from the cooked mesh pack if it is up to date, otherwise cooks the gltf first.
+    // decoding runs in parallel on the job system, uploads happen on the calling thread
+    std::optional<std::vector<std::shared_ptr<MeshAsset>>> loadGltfMeshes(RendererState* state, std::filesystem::path filePath) {
+        PROFILE_ZONE("load meshes");
+        auto packPath = std::filesystem::path(filePath).replace_extension(config::renderer::MESH_PACK_EXTENSION);
+
+        std::optional<std::vector<meshes::EncodedMesh>> encoded = {};
+        if (isPackFresh(packPath, filePath))
+            encoded = readMeshPack(packPath);
+        if (!encoded.has_value())
+            encoded = cookGltfMeshes(filePath, packPath);
+        if (!encoded.has_value())
+            return {};
+
+        struct Decoded {
+            std::vector<u32> indices;
+            std::vector<PackedVertex> vertices;
+            std::atomic<bool> failed = false;
+        };
+        std::vector<Decoded> decoded(encoded->size());
+
+        jobs::Counter counter;
+        for (usize i = 0; i < encoded->size(); i++) {
+            auto& src = (*encoded)[i];
+            auto& dst = decoded[i];
+            dst.indices.resize(src.indexCount);
+            dst.vertices.resize(src.vertexCount);
+            jobs::run(&counter, [&src, &dst] {
+                if (!meshes::decodeVertices(src, dst.vertices)) dst.failed = true;
+            });
+            jobs::run(&counter, [&src, &dst] {
+                if (!meshes::decodeIndices(src, dst.indices)) dst.failed = true;
+            });
+        }
+        jobs::wait(&counter);
+
+        std::vector<std::shared_ptr<MeshAsset>> result;
+        result.reserve(encoded->size());
+        for (usize i = 0; i < encoded->size(); i++) {
+            if (decoded[i].failed) {
+                log::warn(std::format("failed to decode mesh: {}", (*encoded)[i].name));
+                continue;
+            }
+            result.emplace_back(std::make_shared<MeshAsset>(MeshAsset {
+                .name = std::move((*encoded)[i].name),
+                .surfaces = std::move((*encoded)[i].surfaces),
+                .lods = std::move((*encoded)[i].lods),
+                .bounds = (*encoded)[i].bounds,
+                .meshBuffers = vkres::uploadMesh(state, decoded[i].indices, decoded[i].vertices),
+            }));
+        }
+        return result;
     }
-    
-}
\ No newline at end of file
+
+    //---------------------------------------------------
+    // |>~ TEXTURES ~<|
+    //---------------------------------------------------
+
+    // cooked textures are stored next to their source as a single block compressed mip chain
+    static constexpr u32 TEXTURE_PACK_MAGIC = 0x58545846; // "FXTX"
+    static constexpr u32 TEXTURE_PACK_VERSION = 1;
+
+    struct TexturePackHeader {
+        u32 magic;
+        u32 version;
+        u32 format;     // VkFormat
+        u32 width;
+        u32 height;
+        u32 mipCount;   // followed by mipCount u32 level sizes, then the level data
+    };
+
+    bool writeTexturePack(const std::filesystem::path& filePath, const textures::TextureData& texture) {
+        std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        TexturePackHeader header = {
+            TEXTURE_PACK_MAGIC, TEXTURE_PACK_VERSION, (u32)texture.format,
+            texture.width, texture.height, (u32)texture.mipSizes.size(),
+        };
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)texture.mipSizes.data(), (i64)(texture.mipSizes.size() * sizeof(u32)));
+        file.write((const char*)texture.blocks.data(), (i64)texture.blocks.size());
+        return file.good();
+    }
+
+    // fails if the pack is malformed, was cooked for a different encoding or its mip chain does not
+    // match its dimensions. only compressed encodings are cooked into packs
+    bool readTexturePack(const std::filesystem::path& filePath, const textures::Encoding& encoding, textures::TextureData* out) {
+        const VkFormat format = encoding.vkFormat();
+        auto file = utility::readFile(filePath);
+        if (!file.has_value()) return false;
+        const std::vector<u8>& bytes = file.value();
+
+        TexturePackHeader header = {};
+        if (bytes.size() < sizeof(header)) return false;
+        memcpy(&header, bytes.data(), sizeof(header));
+        if (header.magic != TEXTURE_PACK_MAGIC || header.version != TEXTURE_PACK_VERSION || header.format != (u32)format)
+            return false;
+        if (header.width == 0 || header.height == 0 || header.mipCount > (bytes.size() - sizeof(header)) / sizeof(u32))
+            return false;
+
+        if (header.mipCount != (u32)std::floor(std::log2(std::max(header.width, header.height))) + 1)
+            return false;
+
+        usize offset = sizeof(header);
+        out->mipSizes.resize(header.mipCount);
+        memcpy(out->mipSizes.data(), bytes.data() + offset, header.mipCount * sizeof(u32));
+        offset += header.mipCount * sizeof(u32);
+
+        // every level holds whole 4x4 blocks
+        const u32 blockSize = bcn::blockSize(encoding.compression.value());
+        for (u32 level = 0; level < header.mipCount; level++) {
+            const u32 width = std::max(header.width >> level, 1u), height = std::max(header.height >> level, 1u);
+            if (out->mipSizes[level] != ((width + 3) / 4) * ((height + 3) / 4) * blockSize) return false;
+        }
+
+        usize dataSize = 0;
+        for (u32 size : out->mipSizes)
+            dataSize += size;
+        if (dataSize != bytes.size() - offset) return false;
+
+        out->blocks.assign(bytes.begin() + (i64)offset, bytes.end());
+        out->format = format;
+        out->width = header.width;
+        out->height = header.height;
+        return true;
+    }
+
+    // decodes source image bytes, and when the encoding is compressed cooks them into a texture pack
+    bool cookTexture(std::span<const u8> bytes, const textures::Encoding& encoding, const std::filesystem::path& packPath, textures::TextureData* out) {
+        PROFILE_ZONE("cook texture");
+        if (!textures::decode(bytes, out, encoding.vkFormat())) return false;
+        if (!encoding.compression.has_value()) return true;
+
+        *out = textures::compress(*out, encoding.compression.value(), encoding.srgb);
+        if (!writeTexturePack(packPath, *out))
+            log::warn(std::format("failed to write texture pack: {}", packPath.string()));
+        return true;
+    }
+
+    // files are read, decoded and cooked on the job system. compressed encodings load an
+    // up to date texture pack next to the source instead when present
+    std::vector<textures::TextureData> readTextures(std::span<const std::filesystem::path> paths, textures::Encoding encoding = {}) {
+        std::vector<textures::TextureData> loaded(paths.size());
+        jobs::parallelFor((u32)paths.size(), 1, [&](u32 begin, u32 end) {
+            for (u32 i = begin; i < end; i++) {
+                auto packPath = std::filesystem::path(paths[i]).replace_extension(config::renderer::TEXTURE_PACK_EXTENSION);
+                if (encoding.compression.has_value() && isPackFresh(packPath, paths[i]) &&
+                    readTexturePack(packPath, encoding, &loaded[i]))
+                    continue;
+
+                auto bytes = utility::readFile(paths[i]);
+                if (!bytes.has_value() || !cookTexture(bytes.value(), encoding, packPath, &loaded[i]))
+                    log::warn(std::format("failed to load texture: {}", paths[i].string()));
+            }
+        });
+        return loaded;
+    }
+
+    // material slots sampling a gltf image
+    enum ImageUsage : u32 {
+        IMAGE_COLOR = 1 << 0,       // base color, emissive
+        IMAGE_NORMAL = 1 << 1,
+        IMAGE_OCCLUSION = 1 << 2,
+        IMAGE_DATA = 1 << 3,        // metallic roughness
+    };
+
+    std::vector<u32> gltfImageUsage(const fastgltf::Asset& gltf) {
+        std::vector<u32> usage(gltf.images.size(), 0);
+        const auto use = [&](usize textureIndex, u32 slot) {
+            if (textureIndex < gltf.textures.size() && gltf.textures[textureIndex].imageIndex.has_value())
+                usage[gltf.textures[textureIndex].imageIndex.value()] |= slot;
+        };
+        for (const fastgltf::Material& material : gltf.materials) {
+            if (material.pbrData.baseColorTexture.has_value()) use(material.pbrData.baseColorTexture->textureIndex, IMAGE_COLOR);
+            if (material.emissiveTexture.has_value()) use(material.emissiveTexture->textureIndex, IMAGE_COLOR);
+            if (material.normalTexture.has_value()) use(material.normalTexture->textureIndex, IMAGE_NORMAL);
+            if (material.occlusionTexture.has_value()) use(material.occlusionTexture->textureIndex, IMAGE_OCCLUSION);
+            if (material.pbrData.metallicRoughnessTexture.has_value()) use(material.pbrData.metallicRoughnessTexture->textureIndex, IMAGE_DATA);
+        }
+        return usage;
+    }
+
+    // color images are srgb, everything else is linear data in the narrowest block format holding its
+    // channels: rg for normals, r for occlusion. images shared between slots keep every channel, unused
+    // images keep the requested encoding
+    textures::Encoding imageEncoding(u32 usage, const textures::Encoding& requested) {
+        if (usage == 0) return requested;
+        if (usage & IMAGE_COLOR) return { .compression = requested.compression, .srgb = true };
+        if (!requested.compression.has_value()) return { .compression = {}, .srgb = false };
+        if (usage == IMAGE_NORMAL) return { .compression = bcn::Format::BC5, .srgb = false };
+        if (usage == IMAGE_OCCLUSION) return { .compression = bcn::Format::BC4, .srgb = false };
+        return { .compression = requested.compression, .srgb = false };
+    }
+
+    // the external file of an image referenced by uri, embedded images live in the gltf's buffers
+    std::optional<std::filesystem::path> gltfImageSource(const fastgltf::Asset& gltf, const std::filesystem::path& filePath, usize image) {
+        const auto* uri = std::get_if<fastgltf::sources::URI>(&gltf.images[image].data);
+        if (!uri || !uri->uri.isLocalPath()) return {};
+        return filePath.parent_path() / uri->uri.fspath();
+    }
+
+    // returns one texture per gltf image, in gltf image order. cooked images are stored as
+    // <gltf name>.<image index>.ftex next to the gltf, the encoding follows the material slots using them
+    std::vector<textures::TextureData> readGltfTextures(const std::filesystem::path& filePath, textures::Encoding encoding = {}) {
+        PROFILE_ZONE("read textures");
+        auto asset = parseGltf(filePath);
+        if (!asset.has_value()) return {};
+        const fastgltf::Asset& gltf = asset.value();
+        const std::vector<u32> usage = gltfImageUsage(gltf);
+
+        std::vector<textures::TextureData> loaded(gltf.images.size());
+        jobs::parallelFor((u32)gltf.images.size(), 1, [&](u32 begin, u32 end) {
+            for (u32 i = begin; i < end; i++) {
+                const textures::Encoding imageEncoded = imageEncoding(usage[i], encoding);
+                auto packPath = filePath.parent_path() /
+                    std::format("{}.{}{}", filePath.stem().string(), i, config::renderer::TEXTURE_PACK_EXTENSION.string());
+                std::vector<std::filesystem::path> sources = { filePath };
+                if (auto source = gltfImageSource(gltf, filePath, i); source.has_value())
+                    sources.push_back(std::move(source.value()));
+                if (imageEncoded.compression.has_value() && isPackFresh(packPath, sources) &&
+                    readTexturePack(packPath, imageEncoded, &loaded[i]))
+                    continue;
+
+                const auto cookBytes = [&](std::span<const u8> bytes) {
+                    return cookTexture(bytes, imageEncoded, packPath, &loaded[i]);
+                };
+                const bool cookedImage = std::visit(fastgltf::visitor {
+                    [](const auto&) { return false; },
+                    [&](const fastgltf::sources::URI& uri) {
+                        if (!uri.uri.isLocalPath()) return false;
+                        auto bytes = utility::readFile(filePath.parent_path() / uri.uri.fspath());
+                        if (!bytes.has_value() || uri.fileByteOffset > bytes->size()) return false;
+                        return cookBytes(std::span<const u8>(*bytes).subspan(uri.fileByteOffset));
+                    },
+                    [&](const fastgltf::sources::Array& array) {
+                        return cookBytes({ (const u8*)array.bytes.data(), array.bytes.size_bytes() });
+                    },
+                    [&](const fastgltf::sources::BufferView& view) {
+                        auto bytes = fastgltf::DefaultBufferDataAdapter{}(gltf, view.bufferViewIndex);
+                        return cookBytes({ (const u8*)bytes.data(), bytes.size() });
+                    },
+                }, gltf.images[i].data);
+                if (!cookedImage)
+                    log::warn(std::format("failed to decode gltf image {} ({})", i, gltf.images[i].name.c_str()));
+            }
+        });
+        return loaded;
+    }
+
+    // one material per gltf material, in gltf order. base color textures are looked up in textures, which
+    // must hold the gltf's images in image order
+    std::vector<GPUMaterial> readGltfMaterials(const std::filesystem::path& filePath, std::span<const CombinedSampler> textures) {
+        auto asset = parseGltf(filePath);
+        if (!asset.has_value()) return {};
+        const fastgltf::Asset& gltf = asset.value();
+
+        std::vector<GPUMaterial> result;
+        result.reserve(gltf.materials.size());
+        for (const fastgltf::Material& material : gltf.materials) {
+            const auto& factor = material.pbrData.baseColorFactor;
+            GPUMaterial& packed = result.emplace_back(GPUMaterial{
+                .baseColor = { (f32)factor[0], (f32)factor[1], (f32)factor[2], (f32)factor[3] },
+                .alphaCutoff = (f32)material.alphaCutoff,
+            });
+            const auto& baseColor = material.pbrData.baseColorTexture;
+            if (baseColor.has_value() && gltf.textures[baseColor->textureIndex].imageIndex.has_value()) {
+                const usize image = gltf.textures[baseColor->textureIndex].imageIndex.value();
+                if (image < textures.size()) packed.baseColorTexture = textures[image].id;
+            }
+            // blending is not supported yet, blended materials are alpha tested instead
+            if (material.alphaMode != fastgltf::AlphaMode::Opaque) packed.features |= MATERIAL_ALPHA_TEST;
+            if (material.doubleSided) packed.features |= MATERIAL_DOUBLE_SIDED;
+        }
+        return result;
+    }
+
+    // uploads happen on the calling thread
+    std::vector<CombinedSampler> loadTextures(RendererState* state, std::span<const std::filesystem::path> paths, textures::Encoding encoding = {}) {
+        return textures::upload(state, readTextures(paths, encoding));
+    }
+
+    std::vector<CombinedSampler> loadGltfTextures(RendererState* state, const std::filesystem::path& filePath, textures::Encoding encoding = {}) {
+        return textures::upload(state, readGltfTextures(filePath, encoding));
+    }
+
+
+    //---------------------------------------------------
+    // |>~ SYNTHETIC ~<|
+    //---------------------------------------------------
+    // generated content for benchmark scenes, deterministic so runs on different commits match
+
+    // unit uv sphere with a single surface
+    meshes::MeshData generateSphere(u32 rings, u32 segments, u32 material) {
+        meshes::MeshData mesh = { .name = "sphere", .surfaces = {}, .lods = {}, .bounds = {}, .indices = {}, .vertices = {} };
+        for (u32 r = 0; r <= rings; r++) {
+            const f32 v = (f32)r / (f32)rings;
+            const f32 phi = v * glm::pi<f32>();
+            for (u32 s = 0; s <= segments; s++) {
+                const f32 u = (f32)s / (f32)segments;
+                const f32 theta = u * glm::two_pi<f32>();
+                const glm::vec3 n = { sinf(phi) * cosf(theta), cosf(phi), sinf(phi) * sinf(theta) };
+                mesh.vertices.push_back({ .position = n, .uv_x = u, .normal = n, .uv_y = v, .color = glm::vec4(1.f) });
+            }
+        }
+        for (u32 r = 0; r < rings; r++) {
+            for (u32 s = 0; s < segments; s++) {
+                const u32 a = r * (segments + 1) + s, b = a + segments + 1;
+                mesh.indices.insert(mesh.indices.end(), { a, a + 1, b, a + 1, b + 1, b }); // counter clockwise from outside
+            }
+        }
+        mesh.surfaces.push_back({ .startIndex = 0, .count = (u32)mesh.indices.size(), .material = material });
+        mesh.bounds = meshes::computeBounds(mesh.vertices);
+        meshes::buildLods(mesh);
+        return mesh;
+    }
+
+    // count meshes with increasing tessellation, surfaces cycle through materialCount materials
+    std::vector<std::shared_ptr<MeshAsset>> loadSyntheticMeshes(RendererState* state, u32 count, u32 materialCount) {
+        PROFILE_ZONE("load synthetic meshes");
+        std::vector<std::shared_ptr<MeshAsset>> result;
+        result.reserve(count);
+        for (u32 i = 0; i < count; i++) {
+            const u32 detail = 8 + (i % 8) * 4;
+            auto mesh = generateSphere(detail, detail * 2, materialCount > 0 ? i % materialCount : NO_MATERIAL);
+            std::vector<PackedVertex> packed(mesh.vertices.size());
+            for (usize v = 0; v < packed.size(); v++)
+                packed[v] = meshes::quantize(mesh.vertices[v]);
+            result.emplace_back(std::make_shared<MeshAsset>(MeshAsset {
+                .name = std::format("sphere_{}", i),
+                .surfaces = std::move(mesh.surfaces),
+                .lods = std::move(mesh.lods),
+                .bounds = mesh.bounds,
+                .meshBuffers = vkres::uploadMesh(state, mesh.indices, packed),
+            }));
+        }
+        return result;
+    }
+
+    // uncompressed checkerboards, the pixels are malloc'd since stbi_image_free is plain free
+    std::vector<textures::TextureData> generateTextures(u32 count, u32 size) {
+        std::vector<textures::TextureData> result(count);
+        for (u32 i = 0; i < count; i++) {
+            auto& texture = result[i];
+            texture.pixels.reset((u8*)std::malloc((usize)size * size * 4));
+            texture.format = VK_FORMAT_R8G8B8A8_SRGB;
+            texture.width = size;
+            texture.height = size;
+            const u32 cell = 4u << (i % 4);
+            const u8 tint = (u8)(64 + (i * 37) % 192);
+            for (u32 y = 0; y < size; y++) {
+                for (u32 x = 0; x < size; x++) {
+                    u8* pixel = texture.pixels.get() + ((usize)y * size + x) * 4;
+                    const bool dark = ((x / cell) + (y / cell)) % 2 == 0;
+                    pixel[0] = dark ? 32 : tint;
+                    pixel[1] = dark ? 32 : (u8)(255 - tint);
+                    pixel[2] = dark ? 32 : 255;
+                    pixel[3] = 255;
+                }
+            }
+        }
+        return result;
+    }
+
+    // fills a cube around the origin that stays inside the default camera distance
+    std::vector<MeshInstance> placeSyntheticInstances(std::span<const std::shared_ptr<MeshAsset>> meshes, u32 count) {
+        std::vector<MeshInstance> result;
+        if (meshes.empty()) return result;
+        const u32 side = std::max((u32)std::ceil(std::cbrt((f32)count)), 1u);
+        const f32 spacing = 4.f / (f32)side;
+        result.reserve(count);
+        for (u32 i = 0; i < count; i++) {
+            const glm::vec3 cell = { (f32)(i % side), (f32)(i / side % side), (f32)(i / (side * side)) };
+            const glm::vec3 position = (cell - (f32)(side - 1) * .5f) * spacing;
+            result.push_back({
+                .mesh = meshes[i % meshes.size()],
+                .transform = glm::scale(glm::translate(glm::mat4(1.f), position), glm::vec3(spacing * .4f)),
+            });
+        }
+        return result;
+    }
+
+}
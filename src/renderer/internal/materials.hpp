@@ -0,0 +1,109 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "buffers.hpp"
+#include "pipelines.hpp"
+#include "hotreload.hpp"
+
+// bindless material table. materials are packed GPUMaterials in a device local buffer indexed by material
+// id, textures are referenced by their CombinedSamplerId, so draws only push an id and never bind anything
+// per material. changing a material uploads just its slot. the feature bits select one of the mesh pipeline
+// permutations, fragment shader paths are specialized on them and double sided ones disable culling
+namespace flux::renderer::materials {
+
+    static constexpr u32 FEATURES_SPEC_ID = 0;  // must match materialFeatures in mesh.frag
+
+    // features derived from the parameters are kept in sync here
+    GPUMaterial pack(GPUMaterial material) {
+        if (material.baseColorTexture != CombinedSamplerId::INVALID) material.features |= MATERIAL_TEXTURED;
+        else material.features &= ~(u32)MATERIAL_TEXTURED;
+        return material;
+    }
+
+    u32 add(RendererState* state, const GPUMaterial& material) {
+        auto& materials = state->materials;
+        const u32 id = (u32)materials.data.size();
+        materials.data.push_back(pack(material));
+        materials.dirty.push_back(id);
+        return id;
+    }
+
+    void set(RendererState* state, u32 id, const GPUMaterial& material) {
+        state->materials.data[id] = pack(material);
+        state->materials.dirty.push_back(id);
+    }
+
+    const GPUMaterial& get(const RendererState* state, u32 id) {
+        return state->materials.data[id];
+    }
+
+    // points every material sampling from at to instead, e.g. when streaming moved a texture to a new id
+    void replaceTexture(RendererState* state, CombinedSamplerId from, CombinedSamplerId to) {
+        for (u32 id = 0; id < state->materials.data.size(); id++) {
+            if (state->materials.data[id].baseColorTexture != from) continue;
+            GPUMaterial material = state->materials.data[id];
+            material.baseColorTexture = to;
+            set(state, id, material);
+        }
+    }
+
+    // material id of a surface drawn by an instance
+    u32 resolve(const MeshInstance& instance, const GeoSurface& surface) {
+        if (instance.material != NO_MATERIAL) return instance.material;
+        return (surface.material != NO_MATERIAL) ? surface.material : DEFAULT_MATERIAL;
+    }
+
+    // turns the source local material indices of freshly loaded meshes into ids, firstMaterial is the id
+    // of the source's first material
+    void assign(std::span<const std::shared_ptr<MeshAsset>> meshes, u32 firstMaterial) {
+        const auto assignSurfaces = [firstMaterial](std::vector<GeoSurface>& surfaces) {
+            for (auto& surface : surfaces)
+                surface.material = (surface.material != NO_MATERIAL) ? surface.material + firstMaterial : DEFAULT_MATERIAL;
+        };
+        for (auto& mesh : meshes) {
+            assignSurfaces(mesh->surfaces);
+            for (auto& lod : mesh->lods) assignSurfaces(lod.surfaces);
+        }
+    }
+
+    void init(RendererState* state) {
+        add(state, {});
+        state->deinitStack.emplace_back([state] {
+            vkres::destroyResident(state, &state->materials.buffer);
+            state->materials = {};
+        });
+    }
+
+    // one pipeline per feature combination, rebuilt by hot reload like any other
+    void buildPipelines(RendererState* state, const pipelines::PipelineBuilder& builder) {
+        for (u32 features = 0; features < MATERIAL_PERMUTATIONS; features++) {
+            pipelines::PipelineBuilder permutation = builder;
+            permutation.specialization.set(FEATURES_SPEC_ID, features);
+            permutation.setCullMode((features & MATERIAL_DOUBLE_SIDED) ? VK_CULL_MODE_NONE : VK_CULL_MODE_BACK_BIT, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+            hotreload::buildPipeline(state, &state->meshPipelines[features], { "mesh.vert", "mesh.frag" }, DRAW_PUSH_CONSTANTS,
+                [state, builder = permutation](std::span<const VkShaderModule> modules, std::span<const ShaderReflection> reflections) mutable {
+                    builder.setShaders(modules[0], modules[1]);
+                    return builder.build(state->device, reflections);
+                });
+        }
+        state->deinitStack.emplace_back([state] {
+            for (VkPipeline pipeline : state->meshPipelines)
+                vkDestroyPipeline(state->device, pipeline, nullptr);
+        });
+    }
+
+    VkPipeline pipeline(const RendererState* state, u32 id) {
+        return state->meshPipelines[get(state, id).features % MATERIAL_PERMUTATIONS];
+    }
+
+    // uploads the changed slots, recorded before anything reads materials this frame
+    void record(RendererState* state, VkCommandBuffer cmd) {
+        PROFILE_ZONE("material upload");
+        auto& materials = state->materials;
+        const auto ranges = vkres::dirtyRanges(&materials.dirty, 0);
+        materials.dirty.clear();
+        materials.uploadedMaterials = vkres::upload(state, cmd, &materials.buffer, materials.data.data(), sizeof(GPUMaterial), materials.data.size(), ranges,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            config::renderer::MATERIAL_BUFFER_MIN_CAPACITY * sizeof(GPUMaterial));
+    }
+}
@@ -0,0 +1,229 @@
+#pragma once
+#include "../renderer.hpp"
+
+// silence clang for external includes
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+    #include <meshoptimizer/meshoptimizer.h>
+#pragma clang diagnostic pop
+
+namespace flux::renderer::meshes {
+
+    // full precision cpu side mesh, produced by import
+    struct MeshData {
+        std::string name;
+        std::vector<GeoSurface> surfaces;
+        std::vector<MeshLod> lods;
+        glm::vec4 bounds;
+        std::vector<u32> indices;
+        std::vector<Vertex> vertices;
+    };
+
+    // quantized mesh compressed with the meshoptimizer vertex/index codecs, as stored in mesh packs
+    struct EncodedMesh {
+        std::string name;
+        std::vector<GeoSurface> surfaces;
+        std::vector<MeshLod> lods;
+        glm::vec4 bounds = {};
+        u32 vertexCount = 0;
+        u32 indexCount = 0;
+        std::vector<u8> vertexData;
+        std::vector<u8> indexData;
+    };
+
+    // maps a unit vector onto the [-1, 1] octahedron
+    glm::vec2 octEncode(glm::vec3 n) {
+        const f32 sum = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+        if (sum <= 0.f) return { 0.f, 0.f };
+        n /= sum;
+        glm::vec2 result = { n.x, n.y };
+        if (n.z < 0.f) {
+            result = {
+                (1.f - fabsf(n.y)) * (n.x >= 0.f ? 1.f : -1.f),
+                (1.f - fabsf(n.x)) * (n.y >= 0.f ? 1.f : -1.f),
+            };
+        }
+        return result;
+    }
+
+    PackedVertex quantize(const Vertex& v) {
+        const glm::vec2 oct = octEncode(v.normal);
+        return {
+            .position = v.position,
+            .normal = {
+                (i16)meshopt_quantizeSnorm(oct.x, 16),
+                (i16)meshopt_quantizeSnorm(oct.y, 16),
+            },
+            .uv = {
+                meshopt_quantizeHalf(v.uv_x),
+                meshopt_quantizeHalf(v.uv_y),
+            },
+            .color =
+                (u32)meshopt_quantizeUnorm(v.color.r, 8) |
+                (u32)meshopt_quantizeUnorm(v.color.g, 8) << 8 |
+                (u32)meshopt_quantizeUnorm(v.color.b, 8) << 16 |
+                (u32)meshopt_quantizeUnorm(v.color.a, 8) << 24,
+        };
+    }
+
+    glm::vec4 computeBounds(std::span<const Vertex> vertices) {
+        if (vertices.empty()) return {};
+        glm::vec3 min = vertices[0].position, max = vertices[0].position;
+        for (auto& v : vertices) {
+            min = glm::min(min, v.position);
+            max = glm::max(max, v.position);
+        }
+        const glm::vec3 center = (min + max) * .5f;
+        f32 radius = 0.f;
+        for (auto& v : vertices)
+            radius = std::max(radius, glm::length(v.position - center));
+        return { center, radius };
+    }
+
+    // appends simplified index ranges for each lod to mesh.indices, each level targets
+    // LOD_REDUCTION of the previous and is simplified from the full detail surfaces
+    void buildLods(MeshData& mesh) {
+        mesh.lods.clear();
+        if (mesh.vertices.empty()) return;
+
+        const f32* positions = &mesh.vertices[0].position.x;
+        const f32 errorScale = meshopt_simplifyScale(positions, mesh.vertices.size(), sizeof(Vertex));
+
+        usize previousCount = 0;
+        for (auto& surface : mesh.surfaces)
+            previousCount += surface.count;
+
+        std::vector<u32> levelIndices;
+        f32 targetRatio = 1.f;
+        for (u32 level = 0; level < config::renderer::MAX_MESH_LODS; level++) {
+            targetRatio *= config::renderer::LOD_REDUCTION;
+            levelIndices.clear();
+
+            MeshLod lod = { .surfaces = {}, .error = 0.f };
+            for (auto& surface : mesh.surfaces) {
+                const usize targetCount = (usize)((f32)surface.count * targetRatio) / 3 * 3;
+                const usize offset = levelIndices.size();
+                levelIndices.resize(offset + surface.count);
+
+                f32 error = 0.f;
+                const usize count = meshopt_simplify(
+                    levelIndices.data() + offset,
+                    mesh.indices.data() + surface.startIndex, surface.count,
+                    positions, mesh.vertices.size(), sizeof(Vertex),
+                    targetCount, config::renderer::LOD_MAX_SIMPLIFY_ERROR, 0, &error);
+                levelIndices.resize(offset + count);
+
+                lod.surfaces.push_back({
+                    .startIndex = (u32)(mesh.indices.size() + offset),
+                    .count = (u32)count,
+                    .material = surface.material,
+                });
+                lod.error = std::max(lod.error, error * errorScale);
+            }
+
+            // stop once simplification stalls (e.g. error limit reached)
+            if (levelIndices.empty() || (f32)levelIndices.size() > (f32)previousCount * config::renderer::LOD_MIN_REDUCTION)
+                break;
+
+            previousCount = levelIndices.size();
+            mesh.indices.insert(mesh.indices.end(), levelIndices.begin(), levelIndices.end());
+            mesh.lods.push_back(std::move(lod));
+        }
+    }
+
+    struct OptimizeStats {
+        meshopt_VertexCacheStatistics before;
+        meshopt_VertexCacheStatistics after;
+    };
+
+    // reorders every index range for vertex cache efficiency (full detail surfaces also for
+    // overdraw), then reorders vertices for fetch locality. runs after buildLods so lod ranges
+    // are covered by the same vertex remap
+    OptimizeStats optimize(MeshData& mesh) {
+        usize fullDetailCount = 0;
+        for (auto& surface : mesh.surfaces)
+            fullDetailCount += surface.count;
+
+        OptimizeStats result = {};
+        if (mesh.vertices.empty()) return result;
+        result.before = meshopt_analyzeVertexCache(mesh.indices.data(), fullDetailCount, mesh.vertices.size(), config::renderer::VERTEX_CACHE_SIZE, 0, 0);
+
+        const f32* positions = &mesh.vertices[0].position.x;
+        for (auto& surface : mesh.surfaces) {
+            u32* indices = mesh.indices.data() + surface.startIndex;
+            meshopt_optimizeVertexCache(indices, indices, surface.count, mesh.vertices.size());
+            meshopt_optimizeOverdraw(indices, indices, surface.count, positions, mesh.vertices.size(), sizeof(Vertex), config::renderer::OVERDRAW_THRESHOLD);
+        }
+        for (auto& lod : mesh.lods) {
+            for (auto& surface : lod.surfaces) {
+                u32* indices = mesh.indices.data() + surface.startIndex;
+                meshopt_optimizeVertexCache(indices, indices, surface.count, mesh.vertices.size());
+            }
+        }
+
+        std::vector<Vertex> vertices(mesh.vertices.size());
+        vertices.resize(meshopt_optimizeVertexFetch(vertices.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertices.size(), sizeof(Vertex)));
+        mesh.vertices = std::move(vertices);
+
+        result.after = meshopt_analyzeVertexCache(mesh.indices.data(), fullDetailCount, mesh.vertices.size(), config::renderer::VERTEX_CACHE_SIZE, 0, 0);
+        return result;
+    }
+
+    // picks the coarsest lod whose projected error stays below LOD_ERROR_THRESHOLD,
+    // 0 is full detail and n is mesh.lods[n - 1]. pixelsPerUnit is the projected size
+    // of one world unit at distance 1 (viewport height / (2 * tan(fovY / 2)))
+    u32 selectLod(const MeshAsset& mesh, const glm::mat4& transform, glm::vec3 cameraPosition, f32 pixelsPerUnit) {
+        const glm::vec3 center = transform * glm::vec4(glm::vec3(mesh.bounds), 1.f);
+        const f32 scale = std::max({
+            glm::length(glm::vec3(transform[0])),
+            glm::length(glm::vec3(transform[1])),
+            glm::length(glm::vec3(transform[2])),
+        });
+        const f32 distance = glm::length(center - cameraPosition) - mesh.bounds.w * scale;
+        if (distance <= 0.f) return 0;
+
+        u32 result = 0;
+        for (u32 i = 0; i < mesh.lods.size(); i++) {
+            if (mesh.lods[i].error * scale * pixelsPerUnit / distance > config::renderer::LOD_ERROR_THRESHOLD)
+                break;
+            result = i + 1;
+        }
+        return result;
+    }
+
+    EncodedMesh encode(const MeshData& mesh) {
+        std::vector<PackedVertex> packed(mesh.vertices.size());
+        for (usize i = 0; i < packed.size(); i++)
+            packed[i] = quantize(mesh.vertices[i]);
+
+        EncodedMesh result = {
+            .name = mesh.name,
+            .surfaces = mesh.surfaces,
+            .lods = mesh.lods,
+            .bounds = mesh.bounds,
+            .vertexCount = (u32)packed.size(),
+            .indexCount = (u32)mesh.indices.size(),
+        };
+
+        result.vertexData.resize(meshopt_encodeVertexBufferBound(packed.size(), sizeof(PackedVertex)));
+        result.vertexData.resize(meshopt_encodeVertexBuffer(
+            result.vertexData.data(), result.vertexData.size(),
+            packed.data(), packed.size(), sizeof(PackedVertex)));
+
+        result.indexData.resize(meshopt_encodeIndexBufferBound(mesh.indices.size(), packed.size()));
+        result.indexData.resize(meshopt_encodeIndexBuffer(
+            result.indexData.data(), result.indexData.size(),
+            mesh.indices.data(), mesh.indices.size()));
+
+        return result;
+    }
+
+    bool decodeVertices(const EncodedMesh& mesh, std::span<PackedVertex> out) {
+        return meshopt_decodeVertexBuffer(out.data(), mesh.vertexCount, sizeof(PackedVertex), mesh.vertexData.data(), mesh.vertexData.size()) == 0;
+    }
+
+    bool decodeIndices(const EncodedMesh& mesh, std::span<u32> out) {
+        return meshopt_decodeIndexBuffer(out.data(), mesh.indexCount, sizeof(u32), mesh.indexData.data(), mesh.indexData.size()) == 0;
+    }
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "swapchain.hpp"
+#include <core/engine.hpp>
+
+// frame pacing. the frame limiter and the low latency present wait both run before input is sampled,
+// so waiting never adds to input latency. latency is measured from input sampling to the present
+// completing (VK_KHR_present_wait) or, without the extension, to vkQueuePresentKHR returning
+namespace flux::renderer::pacing {
+
+    VkPresentModeKHR toVkPresentMode(engine::PresentMode mode) {
+        switch (mode) {
+            case engine::PresentMode::FIFO: return VK_PRESENT_MODE_FIFO_KHR;
+            case engine::PresentMode::FIFO_RELAXED: return VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            case engine::PresentMode::MAILBOX: return VK_PRESENT_MODE_MAILBOX_KHR;
+            case engine::PresentMode::IMMEDIATE: return VK_PRESENT_MODE_IMMEDIATE_KHR;
+        }
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
+    // before the swapchain is created, presentWait must already reflect the enabled device extensions
+    void init(RendererState* state) {
+        auto& pacing = state->pacing;
+        const auto& options = state->engine->options;
+        pacing.requestedMode = toVkPresentMode(options.presentMode);
+        pacing.fpsLimit = options.fpsLimit;
+        if (pacing.presentWait)
+            pacing.waitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(state->device, "vkWaitForPresentKHR");
+        pacing.presentWait = pacing.waitForPresent != nullptr;
+        pacing.lowLatency = options.lowLatency && pacing.presentWait;
+        if (options.lowLatency && !pacing.presentWait)
+            log::warn("--low-latency needs VK_KHR_present_wait, ignoring");
+    }
+
+    void addLatencySample(RendererState* state, f32 ms) {
+        auto& pacing = state->pacing;
+        pacing.samples[pacing.nextSample] = ms;
+        pacing.nextSample = (pacing.nextSample + 1) % config::renderer::LATENCY_HISTORY;
+        pacing.sampleCount = std::min(pacing.sampleCount + 1, config::renderer::LATENCY_HISTORY);
+        pacing.last = ms;
+
+        std::array<f32, config::renderer::LATENCY_HISTORY> sorted;
+        std::copy_n(pacing.samples.begin(), pacing.sampleCount, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + pacing.sampleCount);
+        f32 sum = 0.f;
+        for (u32 i = 0; i < pacing.sampleCount; i++) sum += sorted[i];
+        pacing.avg = sum / (f32)pacing.sampleCount;
+        pacing.p99 = sorted[std::min(pacing.sampleCount - 1, (u32)std::ceil((f32)pacing.sampleCount * 0.99f) - 1)];
+    }
+
+    // records latency of every present that completed so far. timeout applies to the newest
+    // present only, older ones are polled. stops at the first present that has not completed
+    void collectPresents(RendererState* state, u64 timeout) {
+        auto& pacing = state->pacing;
+        if (!pacing.presentWait) return;
+        const u64 oldest = (pacing.presentId > config::renderer::MAX_PENDING_PRESENTS)
+            ? pacing.presentId - config::renderer::MAX_PENDING_PRESENTS + 1 : 1;
+        for (u64 id = std::max(pacing.completedId + 1, oldest); id <= pacing.presentId; id++) {
+            const VkResult result = pacing.waitForPresent(state->device, state->swapchain, id, id == pacing.presentId ? timeout : 0);
+            if (result != VK_SUCCESS) return; // timeout, or out of date which the next rebuild handles
+            const auto inputTime = pacing.presentInputTimes[id % config::renderer::MAX_PENDING_PRESENTS];
+            addLatencySample(state, std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - inputTime).count());
+            pacing.completedId = id;
+        }
+    }
+
+    void wait(RendererState* state) {
+        auto& pacing = state->pacing;
+        if (state->swapchain) {
+            PROFILE_ZONE("present wait");
+            collectPresents(state, pacing.lowLatency ? config::renderer::PRESENT_WAIT_TIMEOUT : 0);
+        }
+
+        if (pacing.fpsLimit > 0.f) {
+            PROFILE_ZONE("frame limiter");
+            using clock = std::chrono::steady_clock;
+            const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<f64>(1.0 / (f64)pacing.fpsLimit));
+            const auto now = clock::now();
+            // a frame that overran by more than a period restarts the schedule instead of bursting to catch up
+            pacing.nextFrame = (now > pacing.nextFrame + period) ? now : pacing.nextFrame + period;
+            utility::sleepUntil(pacing.nextFrame);
+        }
+        pacing.inputTime = std::chrono::steady_clock::now();
+    }
+
+    // recreates the swapchain once the ui or a caller changed the requested mode, same rules as swapchain::recreate
+    void update(RendererState* state) {
+        auto& pacing = state->pacing;
+        if (!state->swapchain || pacing.requestedMode == pacing.presentMode || !swapchain::supportsPresentMode(state, pacing.requestedMode)) return;
+        PROFILE_ZONE("present mode change");
+        swapchain::recreate(state);
+    }
+
+    // tags the present with an id when present wait is enabled, presentId must outlive the present call
+    void prepare(RendererState* state, VkPresentInfoKHR* presentInfo, VkPresentIdKHR* presentId) {
+        auto& pacing = state->pacing;
+        if (!pacing.presentWait) return;
+        pacing.presentId++;
+        pacing.presentInputTimes[pacing.presentId % config::renderer::MAX_PENDING_PRESENTS] = pacing.inputTime;
+        *presentId = {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+            .pNext = presentInfo->pNext,
+            .swapchainCount = 1,
+            .pPresentIds = &pacing.presentId,
+        };
+        presentInfo->pNext = presentId;
+    }
+
+    // without present wait the latency ends when the present call returns
+    void presented(RendererState* state) {
+        if (state->pacing.presentWait) return;
+        addLatencySample(state, std::chrono::duration<f32, std::milli>(std::chrono::steady_clock::now() - state->pacing.inputTime).count());
+    }
+}
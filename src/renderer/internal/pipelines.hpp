@@ -3,10 +3,12 @@
 #include "vkstructs.hpp"
 #include "helpers.hpp"
 #include "images.hpp"
+#include "reflection.hpp"
 
 namespace flux::renderer::pipelines {
 
-    void initLayout(RendererState* state, const u32 pushConstantSize = 128) {
+    // every pipeline shares this layout, shaders are checked against the push constant range on load
+    void initLayout(RendererState* state, const u32 pushConstantSize = config::renderer::PUSH_CONSTANT_SIZE) {
         VkPushConstantRange pushConstantRange = {
             .stageFlags = VK_SHADER_STAGE_ALL,
             .offset = 0U,
@@ -25,6 +27,29 @@ namespace flux::renderer::pipelines {
         });
     }
 
+    // specialization constants, applied to every stage of a pipeline. bools must be set as VkBool32
+    struct Specialization {
+        std::vector<VkSpecializationMapEntry> entries = {};
+        std::vector<u8> data = {};
+
+        template <typename T>
+        void set(u32 id, T value) {
+            static_assert(sizeof(T) == 4 || sizeof(T) == 8, "specialization constants are 32 or 64 bit");
+            entries.push_back({ .constantID = id, .offset = (u32)data.size(), .size = sizeof(T) });
+            data.resize(data.size() + sizeof(T));
+            std::memcpy(data.data() + entries.back().offset, &value, sizeof(T));
+        }
+
+        VkSpecializationInfo info() const {
+            return {
+                .mapEntryCount = (u32)entries.size(),
+                .pMapEntries = entries.data(),
+                .dataSize = data.size(),
+                .pData = data.data(),
+            };
+        }
+    };
+
     struct PipelineBuilder {
         std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
         VkPipelineInputAssemblyStateCreateInfo inputAssembly;
@@ -35,6 +60,8 @@ namespace flux::renderer::pipelines {
         VkPipelineDepthStencilStateCreateInfo depthStencil;
         VkPipelineRenderingCreateInfo renderInfo;
         VkFormat colorAttachmentformat;
+        VkPipelineCreateFlags flags;
+        Specialization specialization;
 
         PipelineBuilder() { clear(); }
 
@@ -47,9 +74,18 @@ namespace flux::renderer::pipelines {
             depthStencil = { .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
             renderInfo = { .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
             shaderStages.clear();
+            flags = 0;
+            specialization = {};
         }
 
-        VkPipeline build(VkDevice device) {
+        // reflections of the stages, when given, are used to check the specialization constants
+        VkPipeline build(VkDevice device, std::span<const ShaderReflection> reflections = {}) {
+            if (!reflections.empty() && !reflection::validateSpecialization(reflections, "graphics pipeline", specialization.entries))
+                return VK_NULL_HANDLE;
+            const VkSpecializationInfo specializationInfo = specialization.info();
+            for (auto& stage : shaderStages)
+                stage.pSpecializationInfo = specialization.entries.empty() ? nullptr : &specializationInfo;
+
             // make viewport state from stored viewport and scissor, currently multiple viewports or scissors not supported
             VkPipelineViewportStateCreateInfo viewportState = {
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
@@ -68,6 +104,9 @@ namespace flux::renderer::pipelines {
 
             VkPipelineVertexInputStateCreateInfo vertexInputInfo = { .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
 
+            // the builder may have been copied since the format was set, e.g. into a hot reload closure
+            if (renderInfo.colorAttachmentCount > 0) renderInfo.pColorAttachmentFormats = &colorAttachmentformat;
+
             VkDynamicState state[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
             VkPipelineDynamicStateCreateInfo dynamicInfo = {
                 .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
@@ -78,6 +117,7 @@ namespace flux::renderer::pipelines {
             VkGraphicsPipelineCreateInfo pipelineInfo = {
                 .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
                 .pNext = &renderInfo,
+                .flags = flags,
                 .stageCount = (u32)shaderStages.size(),
                 .pStages = shaderStages.data(),
                 .pVertexInputState = &vertexInputInfo,
@@ -151,6 +191,18 @@ namespace flux::renderer::pipelines {
             renderInfo.depthAttachmentFormat = format;
         }
 
+        void enableDepthtest(bool depthWriteEnable, VkCompareOp op) {
+            depthStencil.depthTestEnable = VK_TRUE;
+            depthStencil.depthWriteEnable = depthWriteEnable;
+            depthStencil.depthCompareOp = op;
+            depthStencil.depthBoundsTestEnable = VK_FALSE;
+            depthStencil.stencilTestEnable = VK_FALSE;
+            depthStencil.front = {};
+            depthStencil.back = {};
+            depthStencil.minDepthBounds = 0.f;
+            depthStencil.maxDepthBounds = 1.f;
+        }
+
         void disableDepthtest() {
             depthStencil.depthTestEnable = VK_FALSE;
             depthStencil.depthWriteEnable = VK_FALSE;
@@ -164,4 +216,46 @@ namespace flux::renderer::pipelines {
         }
     };
 
+    // compute pipelines use the global layout and descriptor backend like graphics ones
+    struct ComputePipelineBuilder {
+        VkPipelineShaderStageCreateInfo shaderStage;
+        VkPipelineLayout pipelineLayout;
+        VkPipelineCreateFlags flags;
+        Specialization specialization;
+
+        ComputePipelineBuilder() { clear(); }
+
+        void clear() {
+            shaderStage = {};
+            pipelineLayout = {};
+            flags = 0;
+            specialization = {};
+        }
+
+        void setShader(VkShaderModule computeShader) {
+            shaderStage = vkstruct::pipelineShaderStageCreateInfo(VK_SHADER_STAGE_COMPUTE_BIT, computeShader);
+        }
+
+        // the reflection of the shader, when given, is used to check the specialization constants
+        VkPipeline build(VkDevice device, std::span<const ShaderReflection> reflections = {}) {
+            if (!reflections.empty() && !reflection::validateSpecialization(reflections, "compute pipeline", specialization.entries))
+                return VK_NULL_HANDLE;
+            const VkSpecializationInfo specializationInfo = specialization.info();
+            shaderStage.pSpecializationInfo = specialization.entries.empty() ? nullptr : &specializationInfo;
+
+            VkComputePipelineCreateInfo pipelineInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                .flags = flags,
+                .stage = shaderStage,
+                .layout = pipelineLayout,
+            };
+            VkPipeline pipeline = {};
+            if (vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
+                log::warn("failed to create compute pipeline");
+                return VK_NULL_HANDLE;
+            }
+            return pipeline;
+        }
+    };
+
 }
\ No newline at end of file
@@ -0,0 +1,380 @@
+#pragma once
+#include "../renderer.hpp"
+
+// minimal spir-v reflection, enough to check shaders against the global pipeline layout and the c++
+// push constant structs: entry point stage, push constant block size, member offsets and buffer address
+// strides, descriptor set/binding/kind, workgroup size and specialization constant ids. see the spir-v
+// specification for the opcode and enum values below
+namespace flux::renderer::reflection {
+
+    namespace spv {
+        static constexpr u32 MAGIC = 0x07230203;
+        static constexpr u32 HEADER_WORDS = 5;
+
+        // opcodes
+        static constexpr u32 OP_ENTRY_POINT = 15;
+        static constexpr u32 OP_EXECUTION_MODE = 16;
+        static constexpr u32 OP_TYPE_BOOL = 20;
+        static constexpr u32 OP_TYPE_INT = 21;
+        static constexpr u32 OP_TYPE_FLOAT = 22;
+        static constexpr u32 OP_TYPE_VECTOR = 23;
+        static constexpr u32 OP_TYPE_MATRIX = 24;
+        static constexpr u32 OP_TYPE_IMAGE = 25;
+        static constexpr u32 OP_TYPE_SAMPLER = 26;
+        static constexpr u32 OP_TYPE_SAMPLED_IMAGE = 27;
+        static constexpr u32 OP_TYPE_ARRAY = 28;
+        static constexpr u32 OP_TYPE_RUNTIME_ARRAY = 29;
+        static constexpr u32 OP_TYPE_STRUCT = 30;
+        static constexpr u32 OP_TYPE_POINTER = 32;
+        static constexpr u32 OP_CONSTANT = 43;
+        static constexpr u32 OP_SPEC_CONSTANT_TRUE = 48;
+        static constexpr u32 OP_SPEC_CONSTANT_FALSE = 49;
+        static constexpr u32 OP_SPEC_CONSTANT = 50;
+        static constexpr u32 OP_VARIABLE = 59;
+        static constexpr u32 OP_DECORATE = 71;
+        static constexpr u32 OP_MEMBER_DECORATE = 72;
+        static constexpr u32 OP_TYPE_ACCELERATION_STRUCTURE = 5341;
+        static constexpr u32 OP_TYPE_FORWARD_POINTER = 39;
+
+        // execution models
+        static constexpr u32 MODEL_VERTEX = 0;
+        static constexpr u32 MODEL_FRAGMENT = 4;
+        static constexpr u32 MODEL_COMPUTE = 5;
+        static constexpr u32 MODEL_TASK = 5364;
+        static constexpr u32 MODEL_MESH = 5365;
+
+        // execution modes
+        static constexpr u32 MODE_LOCAL_SIZE = 17;
+        static constexpr u32 MODE_LOCAL_SIZE_ID = 38;
+
+        // decorations
+        static constexpr u32 DECORATION_SPEC_ID = 1;
+        static constexpr u32 DECORATION_BUFFER_BLOCK = 3;
+        static constexpr u32 DECORATION_ARRAY_STRIDE = 6;
+        static constexpr u32 DECORATION_MATRIX_STRIDE = 7;
+        static constexpr u32 DECORATION_BINDING = 33;
+        static constexpr u32 DECORATION_DESCRIPTOR_SET = 34;
+        static constexpr u32 DECORATION_OFFSET = 35;
+
+        // storage classes
+        static constexpr u32 STORAGE_UNIFORM_CONSTANT = 0;
+        static constexpr u32 STORAGE_UNIFORM = 2;
+        static constexpr u32 STORAGE_PUSH_CONSTANT = 9;
+        static constexpr u32 STORAGE_STORAGE_BUFFER = 12;
+        static constexpr u32 STORAGE_PHYSICAL_STORAGE_BUFFER = 5349;
+    }
+
+    struct Type {
+        u32 opcode = 0;
+        u32 width = 0;          // bits of scalars, element count of vectors, column count of matrices
+        u32 element = 0;        // vector, matrix, array and pointer element type
+        u32 lengthId = 0;       // array length constant
+        u32 storage = 0;        // pointers
+        u32 sampled = 0;        // images, 1 sampled, 2 storage
+        std::vector<u32> members = {};
+    };
+
+    struct Decorations {
+        u32 binding = ~0u;
+        u32 set = ~0u;
+        u32 specId = ~0u;
+        u32 arrayStride = 0;
+        bool bufferBlock = false;
+        std::vector<u32> memberOffsets = {};
+        std::vector<u32> memberMatrixStrides = {};
+    };
+
+    struct Module {
+        std::unordered_map<u32, Type> types;
+        std::unordered_map<u32, u32> constants;     // low word, enough for lengths and sizes
+        std::unordered_map<u32, Decorations> decorations;
+        std::unordered_map<u32, u32> specConstantSizes;
+        struct Variable { u32 type, id, storage; };
+        std::vector<Variable> variables;
+    };
+
+    u32 typeSize(const Module& parsed, u32 id, u32 matrixStride = 0, u32 depth = 0) {
+        const auto it = parsed.types.find(id);
+        if (it == parsed.types.end() || depth > 32) return 0;
+        const Type& type = it->second;
+        switch (type.opcode) {
+            case spv::OP_TYPE_BOOL: return 4;
+            case spv::OP_TYPE_INT:
+            case spv::OP_TYPE_FLOAT: return type.width / 8;
+            case spv::OP_TYPE_VECTOR: return type.width * typeSize(parsed, type.element, 0, depth + 1);
+            case spv::OP_TYPE_MATRIX: return type.width * (matrixStride ? matrixStride : typeSize(parsed, type.element, 0, depth + 1));
+            case spv::OP_TYPE_POINTER: return type.storage == spv::STORAGE_PHYSICAL_STORAGE_BUFFER ? 8 : 0;
+            case spv::OP_TYPE_ARRAY: {
+                const auto decorations = parsed.decorations.find(id);
+                const u32 stride = (decorations != parsed.decorations.end() && decorations->second.arrayStride)
+                    ? decorations->second.arrayStride : typeSize(parsed, type.element, 0, depth + 1);
+                const auto length = parsed.constants.find(type.lengthId);
+                return (length != parsed.constants.end()) ? length->second * stride : 0;
+            }
+            case spv::OP_TYPE_STRUCT: {
+                const auto decorations = parsed.decorations.find(id);
+                u32 size = 0;
+                for (usize i = 0; i < type.members.size(); i++) {
+                    u32 offset = size, stride = 0;
+                    if (decorations != parsed.decorations.end()) {
+                        if (i < decorations->second.memberOffsets.size()) offset = decorations->second.memberOffsets[i];
+                        if (i < decorations->second.memberMatrixStrides.size()) stride = decorations->second.memberMatrixStrides[i];
+                    }
+                    size = std::max(size, offset + typeSize(parsed, type.members[i], stride, depth + 1));
+                }
+                return size;
+            }
+            default: return 0;
+        }
+    }
+
+    // unwraps pointers and arrays down to the resource type
+    u32 resourceTypeId(const Module& parsed, u32 id) {
+        for (u32 depth = 0; depth < 8; depth++) {
+            const auto it = parsed.types.find(id);
+            if (it == parsed.types.end()) return id;
+            const u32 opcode = it->second.opcode;
+            if (opcode != spv::OP_TYPE_POINTER && opcode != spv::OP_TYPE_ARRAY && opcode != spv::OP_TYPE_RUNTIME_ARRAY) return id;
+            id = it->second.element;
+        }
+        return id;
+    }
+
+    Binding descriptorKind(const Module& parsed, const Module::Variable& variable, u32 resourceId, const Type& type) {
+        if (type.opcode == spv::OP_TYPE_SAMPLED_IMAGE) return Binding::COMBINED_SAMPLER;
+        if (type.opcode == spv::OP_TYPE_IMAGE && type.sampled == 2) return Binding::STORAGE_IMAGE;
+        if (type.opcode == spv::OP_TYPE_ACCELERATION_STRUCTURE) return Binding::ACCELERATION_STRUCTURE;
+        if (type.opcode != spv::OP_TYPE_STRUCT) return Binding::COUNT;
+        if (variable.storage == spv::STORAGE_STORAGE_BUFFER) return Binding::STORAGE_BUFFER;
+        const auto decorations = parsed.decorations.find(resourceId);
+        const bool bufferBlock = decorations != parsed.decorations.end() && decorations->second.bufferBlock;
+        return bufferBlock ? Binding::STORAGE_BUFFER : Binding::UNIFORM_BUFFER;
+    }
+
+    // fails on anything that is not a spir-v module with exactly one entry point
+    bool reflect(std::span<const u32> code, ShaderReflection* out) {
+        if (code.size() < spv::HEADER_WORDS || code[0] != spv::MAGIC) return false;
+        *out = {};
+        Module parsed;
+        u32 entryPoints = 0, model = 0;
+        std::array<u32, 3> localSizeIds = {};
+        bool localSizeFromIds = false;
+
+        for (usize offset = spv::HEADER_WORDS; offset < code.size();) {
+            const u32 wordCount = code[offset] >> 16;
+            const u32 opcode = code[offset] & 0xffff;
+            if (wordCount == 0 || offset + wordCount > code.size()) return false;
+            const std::span<const u32> operands = code.subspan(offset + 1, wordCount - 1);
+            offset += wordCount;
+
+            const auto operand = [&](usize i) { return (i < operands.size()) ? operands[i] : 0u; };
+            switch (opcode) {
+                case spv::OP_ENTRY_POINT:
+                    model = operand(0);
+                    entryPoints++;
+                    break;
+                case spv::OP_EXECUTION_MODE:
+                    if (operand(1) == spv::MODE_LOCAL_SIZE || operand(1) == spv::MODE_LOCAL_SIZE_ID) {
+                        localSizeFromIds = operand(1) == spv::MODE_LOCAL_SIZE_ID;
+                        for (usize i = 0; i < 3; i++) {
+                            out->workgroupSize[i] = operand(2 + i);
+                            localSizeIds[i] = operand(2 + i);
+                        }
+                    }
+                    break;
+                case spv::OP_TYPE_BOOL:
+                    parsed.types[operand(0)] = { .opcode = opcode };
+                    break;
+                case spv::OP_TYPE_INT:
+                case spv::OP_TYPE_FLOAT:
+                case spv::OP_TYPE_VECTOR:
+                case spv::OP_TYPE_MATRIX:
+                    parsed.types[operand(0)] = opcode == spv::OP_TYPE_INT || opcode == spv::OP_TYPE_FLOAT
+                        ? Type{ .opcode = opcode, .width = operand(1) }
+                        : Type{ .opcode = opcode, .width = operand(2), .element = operand(1) };
+                    break;
+                case spv::OP_TYPE_IMAGE:
+                    parsed.types[operand(0)] = { .opcode = opcode, .sampled = operand(6) };
+                    break;
+                case spv::OP_TYPE_SAMPLER:
+                case spv::OP_TYPE_ACCELERATION_STRUCTURE:
+                    parsed.types[operand(0)] = { .opcode = opcode };
+                    break;
+                case spv::OP_TYPE_SAMPLED_IMAGE:
+                case spv::OP_TYPE_RUNTIME_ARRAY:
+                    parsed.types[operand(0)] = { .opcode = opcode, .element = operand(1) };
+                    break;
+                case spv::OP_TYPE_ARRAY:
+                    parsed.types[operand(0)] = { .opcode = opcode, .element = operand(1), .lengthId = operand(2) };
+                    break;
+                case spv::OP_TYPE_STRUCT:
+                    parsed.types[operand(0)] = { .opcode = opcode, .members = { operands.begin() + 1, operands.end() } };
+                    break;
+                case spv::OP_TYPE_POINTER:
+                    parsed.types[operand(0)] = { .opcode = opcode, .element = operand(2), .storage = operand(1) };
+                    break;
+                case spv::OP_TYPE_FORWARD_POINTER:
+                    parsed.types.try_emplace(operand(0), Type{ .opcode = spv::OP_TYPE_POINTER, .storage = operand(1) });
+                    break;
+                case spv::OP_CONSTANT:
+                    parsed.constants[operand(1)] = operand(2);
+                    break;
+                case spv::OP_SPEC_CONSTANT_TRUE:
+                case spv::OP_SPEC_CONSTANT_FALSE:
+                    parsed.constants[operand(1)] = (opcode == spv::OP_SPEC_CONSTANT_TRUE) ? 1 : 0;
+                    parsed.specConstantSizes[operand(1)] = 4;
+                    break;
+                case spv::OP_SPEC_CONSTANT:
+                    parsed.constants[operand(1)] = operand(2);
+                    parsed.specConstantSizes[operand(1)] = (u32)(operands.size() - 2) * 4;
+                    break;
+                case spv::OP_VARIABLE:
+                    parsed.variables.push_back({ .type = operand(0), .id = operand(1), .storage = operand(2) });
+                    break;
+                case spv::OP_DECORATE: {
+                    Decorations& decorations = parsed.decorations[operand(0)];
+                    if (operand(1) == spv::DECORATION_BINDING) decorations.binding = operand(2);
+                    else if (operand(1) == spv::DECORATION_DESCRIPTOR_SET) decorations.set = operand(2);
+                    else if (operand(1) == spv::DECORATION_SPEC_ID) decorations.specId = operand(2);
+                    else if (operand(1) == spv::DECORATION_ARRAY_STRIDE) decorations.arrayStride = operand(2);
+                    else if (operand(1) == spv::DECORATION_BUFFER_BLOCK) decorations.bufferBlock = true;
+                    break;
+                }
+                case spv::OP_MEMBER_DECORATE: {
+                    if (operand(2) != spv::DECORATION_OFFSET && operand(2) != spv::DECORATION_MATRIX_STRIDE) break;
+                    Decorations& decorations = parsed.decorations[operand(0)];
+                    auto& values = (operand(2) == spv::DECORATION_OFFSET) ? decorations.memberOffsets : decorations.memberMatrixStrides;
+                    if (values.size() <= operand(1)) values.resize(operand(1) + 1, 0);
+                    values[operand(1)] = operand(3);
+                    break;
+                }
+                default: break;
+            }
+        }
+        if (entryPoints != 1) return false;
+
+        if (model == spv::MODEL_VERTEX) out->stage = VK_SHADER_STAGE_VERTEX_BIT;
+        else if (model == spv::MODEL_FRAGMENT) out->stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        else if (model == spv::MODEL_COMPUTE) out->stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        else if (model == spv::MODEL_TASK) out->stage = VK_SHADER_STAGE_TASK_BIT_EXT;
+        else if (model == spv::MODEL_MESH) out->stage = VK_SHADER_STAGE_MESH_BIT_EXT;
+
+        // workgroup dimensions given by (spec) constant ids use the constant's default value
+        if (localSizeFromIds) {
+            for (usize i = 0; i < 3; i++) {
+                const auto constant = parsed.constants.find(localSizeIds[i]);
+                out->workgroupSize[i] = (constant != parsed.constants.end()) ? constant->second : 0;
+                const auto decorations = parsed.decorations.find(localSizeIds[i]);
+                if (decorations != parsed.decorations.end()) out->workgroupSizeSpecIds[i] = decorations->second.specId;
+            }
+        }
+
+        for (const auto& [id, size] : parsed.specConstantSizes) {
+            const auto decorations = parsed.decorations.find(id);
+            if (decorations != parsed.decorations.end() && decorations->second.specId != ~0u)
+                out->specConstants.push_back({ .id = decorations->second.specId, .size = size });
+        }
+        std::sort(out->specConstants.begin(), out->specConstants.end(), [](const auto& a, const auto& b) { return a.id < b.id; });
+
+        for (const auto& variable : parsed.variables) {
+            if (variable.storage == spv::STORAGE_PUSH_CONSTANT) {
+                const u32 block = resourceTypeId(parsed, variable.type);
+                out->pushConstantSize = typeSize(parsed, block);
+                const auto decorations = parsed.decorations.find(block);
+                if (decorations != parsed.decorations.end()) out->pushConstantOffsets = decorations->second.memberOffsets;
+
+                // indexing through a physical storage buffer pointer needs an ArrayStride on the pointer type
+                const auto type = parsed.types.find(block);
+                if (type == parsed.types.end()) continue;
+                for (const u32 member : type->second.members) {
+                    const auto pointer = parsed.types.find(member);
+                    const auto pointerDecorations = parsed.decorations.find(member);
+                    const bool address = pointer != parsed.types.end() && pointer->second.opcode == spv::OP_TYPE_POINTER
+                        && pointer->second.storage == spv::STORAGE_PHYSICAL_STORAGE_BUFFER;
+                    out->pushConstantStrides.push_back((address && pointerDecorations != parsed.decorations.end()) ? pointerDecorations->second.arrayStride : 0);
+                }
+                continue;
+            }
+            if (variable.storage != spv::STORAGE_UNIFORM_CONSTANT && variable.storage != spv::STORAGE_UNIFORM
+                && variable.storage != spv::STORAGE_STORAGE_BUFFER) continue;
+            const auto decorations = parsed.decorations.find(variable.id);
+            if (decorations == parsed.decorations.end() || decorations->second.binding == ~0u) continue;
+            const u32 resource = resourceTypeId(parsed, variable.type);
+            const auto type = parsed.types.find(resource);
+            out->descriptors.push_back({
+                .set = decorations->second.set == ~0u ? 0 : decorations->second.set,
+                .binding = decorations->second.binding,
+                .kind = (type != parsed.types.end()) ? descriptorKind(parsed, variable, resource, type->second) : Binding::COUNT,
+            });
+        }
+        return true;
+    }
+
+    //---------------------------------------------------
+    // |>~ VALIDATION ~<|
+    //---------------------------------------------------
+
+    // every descriptor must be in the global set at the binding of its kind, see descriptors.hpp
+    bool validateDescriptors(const ShaderReflection& reflection, std::string_view name) {
+        bool valid = true;
+        for (const auto& descriptor : reflection.descriptors) {
+            if (descriptor.set == 0 && descriptor.kind != Binding::COUNT && descriptor.binding == (u32)descriptor.kind) continue;
+            if (descriptor.kind == Binding::COUNT)
+                log::warn(std::format("{}: descriptor at set {} binding {} has a type the global layout does not have", name, descriptor.set, descriptor.binding));
+            else
+                log::warn(std::format("{}: descriptor at set {} binding {} does not match the global layout, expected set 0 binding {}",
+                    name, descriptor.set, descriptor.binding, (u32)descriptor.kind));
+            valid = false;
+        }
+        return valid;
+    }
+
+    // the shader's push constant block must fit the layout range and, when the c++ side is given, have
+    // the same member offsets and not read past its end. shaders may declare a prefix of the struct.
+    // buffer addresses the shader indexes must step by the size of the c++ element, a layout mismatch
+    // (std430 instead of scalar) shows up here as a larger stride
+    bool validatePushConstants(const ShaderReflection& reflection, std::string_view name, const PushConstantLayout& expected) {
+        if (reflection.pushConstantSize > config::renderer::PUSH_CONSTANT_SIZE) {
+            log::warn(std::format("{}: push constants are {} bytes, the layout has {}", name, reflection.pushConstantSize, config::renderer::PUSH_CONSTANT_SIZE));
+            return false;
+        }
+        if (expected.size == 0 || reflection.pushConstantSize == 0) return true;
+        if (reflection.pushConstantSize > expected.size) {
+            log::warn(std::format("{}: push constants are {} bytes, the c++ struct has {}", name, reflection.pushConstantSize, expected.size));
+            return false;
+        }
+        for (usize i = 0; i < reflection.pushConstantOffsets.size(); i++) {
+            if (i < expected.offsets.size() && reflection.pushConstantOffsets[i] == expected.offsets[i]) continue;
+            log::warn(std::format("{}: push constant member {} is at offset {}, the c++ struct has {}", name, i,
+                reflection.pushConstantOffsets[i], i < expected.offsets.size() ? std::format("{}", expected.offsets[i]) : "no such member"));
+            return false;
+        }
+        for (usize i = 0; i < reflection.pushConstantStrides.size() && i < expected.strides.size(); i++) {
+            if (reflection.pushConstantStrides[i] == 0 || expected.strides[i] == 0 || reflection.pushConstantStrides[i] == expected.strides[i]) continue;
+            log::warn(std::format("{}: push constant member {} steps {} bytes per element, the c++ struct has {}", name, i,
+                reflection.pushConstantStrides[i], expected.strides[i]));
+            return false;
+        }
+        return true;
+    }
+
+    // a specialization constant the pipeline sets must have the size the shader declares, stages that do
+    // not declare it ignore it. one that no stage declares is most likely a wrong id
+    bool validateSpecialization(std::span<const ShaderReflection> reflections, std::string_view name, std::span<const VkSpecializationMapEntry> entries) {
+        bool valid = true;
+        for (const auto& entry : entries) {
+            bool used = false;
+            for (const auto& reflection : reflections) {
+                const auto declared = std::find_if(reflection.specConstants.begin(), reflection.specConstants.end(),
+                    [&](const ShaderReflection::SpecConstant& constant) { return constant.id == entry.constantID; });
+                if (declared == reflection.specConstants.end()) continue;
+                used = true;
+                if (declared->size == entry.size) continue;
+                log::warn(std::format("{}: specialization constant {} is {} bytes, the shader declares {}", name, entry.constantID, entry.size, declared->size));
+                valid = false;
+            }
+            if (!used) log::warn(std::format("{}: no shader declares specialization constant {}", name, entry.constantID));
+        }
+        return valid;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include <core/engine.hpp>
+
+// dynamic resolution. renderScale follows the gpu "frame" scope against a frame time budget, the
+// frame is rendered into the scaled corner of the draw image and the swapchain blit upscales it.
+// gpu cost is assumed to scale with pixel count, so the scale moves with the square root of the
+// time ratio. timings trail by FRAME_OVERLAP frames, after a change the controller waits for frames
+// rendered at the new scale before measuring again
+namespace flux::renderer::resolution {
+
+    void init(RendererState* state) {
+        auto& resolution = state->resolution;
+        resolution.targetMs = state->engine->options.dynamicResolutionMs;
+        resolution.enabled = resolution.targetMs > 0.f && !state->engine->options.headless;
+        if (resolution.targetMs <= 0.f) resolution.targetMs = config::renderer::DYNAMIC_RESOLUTION_DEFAULT_MS;
+    }
+
+    const GpuScopeStats* frameStats(const RendererState* state) {
+        for (const auto& stats : state->gpuProfiler.stats)
+            if (stats.parent == GpuScopeStats::ROOT && std::string_view(stats.name) == "frame") return &stats;
+        return nullptr;
+    }
+
+    // after gpuprofiler::collect, so the newest frame time is known
+    void update(RendererState* state) {
+        auto& resolution = state->resolution;
+        if (!resolution.enabled || !state->gpuProfiler.enabled) return;
+        if (resolution.settleFrames > 0) {
+            resolution.settleFrames--;
+            return;
+        }
+        const GpuScopeStats* stats = frameStats(state);
+        if (!stats || stats->sampleCount == 0) return;
+
+        // smoothed so a single slow frame does not drop the resolution
+        resolution.gpuMs = (resolution.gpuMs == 0.f) ? stats->last
+            : glm::mix(resolution.gpuMs, stats->last, config::renderer::DYNAMIC_RESOLUTION_SMOOTHING);
+
+        const f32 budget = resolution.targetMs * config::renderer::DYNAMIC_RESOLUTION_HEADROOM;
+        const f32 desired = state->renderScale * std::sqrt(budget / std::max(resolution.gpuMs, 0.01f));
+        if (std::abs(desired / state->renderScale - 1.f) < config::renderer::DYNAMIC_RESOLUTION_DEADBAND) return;
+
+        const f32 step = config::renderer::DYNAMIC_RESOLUTION_MAX_STEP;
+        const f32 scale = std::clamp(std::clamp(desired, state->renderScale - step, state->renderScale + step),
+            config::renderer::DYNAMIC_RESOLUTION_MIN_SCALE, 1.f);
+        if (math::cmpF32(scale, state->renderScale)) return;
+        state->renderScale = scale;
+        resolution.gpuMs = 0.f;
+        resolution.settleFrames = config::renderer::FRAME_OVERLAP + 1;
+    }
+
+    // the rendered part of the draw image, clamped to it and never empty
+    VkExtent2D drawExtent(const RendererState* state) {
+        const VkExtent3D drawSize = state->drawImage.image.extent;
+        if (state->engine->options.headless) return { drawSize.width, drawSize.height };
+        const auto scaled = [](u32 size, f32 scale, u32 limit) {
+            return std::clamp((u32)std::lround((f32)size * scale), 1u, limit);
+        };
+        return {
+            scaled(state->swapchainExtent.width, state->renderScale, drawSize.width),
+            scaled(state->swapchainExtent.height, state->renderScale, drawSize.height),
+        };
+    }
+}
@@ -2,10 +2,12 @@
 #include "../renderer.hpp"
 #include "vkstructs.hpp"
 #include "helpers.hpp"
+#include "reflection.hpp"
 
 namespace flux::renderer::vkutil {
 
-    bool loadShaderModule(const char* filePath, VkDevice device, VkShaderModule* outShaderModule) {
+    // reflection is filled from the spir-v when given, a module that cannot be reflected fails to load
+    bool loadShaderModule(const char* filePath, VkDevice device, VkShaderModule* outShaderModule, ShaderReflection* reflection = nullptr) {
         std::ifstream file(filePath, std::ios::ate | std::ios::binary);
         if (!file.is_open()) return false;
         usize fileSize = (usize)file.tellg();
@@ -14,6 +16,11 @@ namespace flux::renderer::vkutil {
         file.read((char*)buffer.data(), (i64)fileSize);
         file.close();
 
+        if (reflection && !reflection::reflect(buffer, reflection)) {
+            log::warn(std::format("failed to reflect {}", filePath));
+            return false;
+        }
+
         VkShaderModuleCreateInfo createInfo = {
             .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
             .codeSize = buffer.size() * sizeof(u32),
@@ -0,0 +1,297 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "images.hpp"
+#include "buffers.hpp"
+#include "descriptors.hpp"
+#include "deletion.hpp"
+#include "textures.hpp"
+#include "materials.hpp"
+
+// feedback driven texture streaming. compressed textures keep their full cooked mip chain in system
+// memory and only the tail at or below STREAMING_RESIDENT_SIZE is uploaded at load. fragment shaders
+// write the texel resolution they need per combined sampler id into a per frame feedback buffer, which
+// is read back once that frame's fence has signalled. residency changes recreate the image with the new
+// mip range, copy shared levels on the gpu, upload the missing ones and move the texture to a new
+// descriptor id, frames in flight keep sampling the old one until it is recycled
+namespace flux::renderer::streaming {
+
+    void init(RendererState* state) {
+        for (usize i = 0; i < config::renderer::FRAME_OVERLAP; i++) {
+            state->streaming.feedback[i] = vkres::createBuffer(state->allocator, config::renderer::MAX_DESCRIPTOR_COUNT * sizeof(u32),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                VMA_MEMORY_USAGE_GPU_TO_CPU);
+            memset(state->streaming.feedback[i].allocation->GetMappedData(), 0, config::renderer::MAX_DESCRIPTOR_COUNT * sizeof(u32));
+            vmaFlushAllocation(state->allocator, state->streaming.feedback[i].allocation, 0, VK_WHOLE_SIZE);
+
+            VkBufferDeviceAddressInfo addressInfo = {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+                .buffer = state->streaming.feedback[i].buffer,
+            };
+            state->streaming.feedbackAddress[i] = vkGetBufferDeviceAddress(state->device, &addressInfo);
+        }
+        state->deinitStack.emplace_back([state] {
+            for (auto& buffer : state->streaming.feedback)
+                vkres::destroyBuffer(state->allocator, buffer);
+        });
+    }
+
+    VkDeviceAddress getFeedbackAddress(RendererState* state) {
+        return state->streaming.feedbackAddress[state->frameNumber % config::renderer::FRAME_OVERLAP];
+    }
+
+    usize residentSize(const StreamedTexture& texture, u32 firstMip) {
+        usize result = 0;
+        for (usize level = firstMip; level < texture.mipSizes.size(); level++)
+            result += texture.mipSizes[level];
+        return result;
+    }
+
+    // maps a requested texel resolution onto the level that provides at least that much detail
+    u32 mipForResolution(const StreamedTexture& texture, u32 resolution) {
+        const u32 size = std::max(texture.width, texture.height);
+        if (resolution >= size) return 0;
+        const u32 mip = (u32)std::floor(std::log2((f32)size / (f32)resolution));
+        return std::min(mip, texture.tailMip);
+    }
+
+    // appends textures to state->textures. compressed ones are streamed and start with only their
+    // tail resident, uncompressed ones are uploaded fully and never change residency
+    void addTextures(RendererState* state, std::vector<textures::TextureData>&& loaded) {
+        std::vector<textures::TextureData> uploads(loaded.size());
+        std::vector<StreamedTexture> streamed(loaded.size());
+        for (usize i = 0; i < loaded.size(); i++) {
+            if (loaded[i].blocks.empty()) {
+                uploads[i] = std::move(loaded[i]);
+                continue;
+            }
+
+            StreamedTexture& texture = streamed[i];
+            texture.width = loaded[i].width;
+            texture.height = loaded[i].height;
+            texture.tailMip = 0;
+            while (texture.tailMip + 1 < loaded[i].mipSizes.size() &&
+                   std::max(texture.width, texture.height) >> texture.tailMip > config::renderer::STREAMING_RESIDENT_SIZE)
+                texture.tailMip++;
+            texture.residentMip = texture.tailMip;
+            texture.requestedMip = texture.tailMip;
+
+            uploads[i] = textures::mipTail(loaded[i], texture.tailMip);
+            texture.blocks = std::move(loaded[i].blocks);
+            texture.mipSizes = std::move(loaded[i].mipSizes);
+            state->streaming.residentBytes += uploads[i].size();
+        }
+
+        auto samplers = textures::upload(state, uploads);
+        state->textures.insert(state->textures.end(), samplers.begin(), samplers.end());
+        state->streaming.textures.insert(state->streaming.textures.end(),
+            std::make_move_iterator(streamed.begin()), std::make_move_iterator(streamed.end()));
+    }
+
+    // recreates the image of a streamed texture with firstMip as its most detailed level under a new
+    // descriptor id and repoints the materials using it. the previous image and id stay alive until the
+    // current frame retires, which is after every earlier frame that could still sample them. feedback
+    // written under the old id is lost for a frame, which eviction tolerates
+    void setResidency(RendererState* state, u32 index, u32 firstMip) {
+        StreamedTexture& streamed = state->streaming.textures[index];
+        CombinedSampler& texture = state->textures[index];
+
+        state->streaming.pendingUploads.push_back({
+            .texture = index,
+            .previousMip = streamed.residentMip,
+            .previous = texture.image,
+        });
+        deletion::retireImageView(state, texture.view);
+        deletion::retireImage(state, texture.image);
+
+        state->streaming.residentBytes -= residentSize(streamed, streamed.residentMip);
+        state->streaming.residentBytes += residentSize(streamed, firstMip);
+        streamed.residentMip = firstMip;
+
+        texture.image = vkres::createImage(state->allocator,
+            { std::max(streamed.width >> firstMip, 1u), std::max(streamed.height >> firstMip, 1u), 1 },
+            texture.image.format, vkres::TEXTURE_USES, true);
+        texture.view = vkres::createImageView(state, texture.image);
+        texture.descriptorInfo.imageView = texture.view;
+        const CombinedSamplerId previousId = texture.id;
+        texture.id = descriptors::registerCombinedSampler(state, texture.view, texture.sampler);
+        descriptors::unregister(state, previousId);
+        materials::replaceTexture(state, previousId, texture.id);
+    }
+
+    // reads back the feedback of the frame that last used the current frame slot and schedules residency
+    // changes under STREAMING_BUDGET. must run after the current frame's fence wait and before
+    // descriptors::updatePending so swapped descriptors are written before recording
+    void update(RendererState* state) {
+        PROFILE_ZONE("streaming update");
+        state->streaming.uploads = 0;
+        state->streaming.evictions = 0;
+
+        const AllocatedBuffer& feedback = state->streaming.feedback[state->frameNumber % config::renderer::FRAME_OVERLAP];
+        vmaInvalidateAllocation(state->allocator, feedback.allocation, 0, VK_WHOLE_SIZE);
+        const u32* requests = (const u32*)feedback.allocation->GetMappedData();
+
+        std::vector<u32> candidates;
+        for (u32 i = 0; i < state->streaming.textures.size(); i++) {
+            StreamedTexture& texture = state->streaming.textures[i];
+            if (texture.blocks.empty() || state->textures[i].id == CombinedSamplerId::INVALID) continue;
+
+            const u32 resolution = requests[(u32)state->textures[i].id];
+            if (resolution > 0) {
+                texture.requestedMip = mipForResolution(texture, resolution);
+                texture.lastRequestedFrame = state->frameNumber;
+            }
+            else if (state->frameNumber - texture.lastRequestedFrame > config::renderer::STREAMING_EVICT_FRAMES)
+                texture.requestedMip = texture.tailMip;
+
+            if (texture.requestedMip != texture.residentMip)
+                candidates.push_back(i);
+        }
+
+        // evictions first to free budget, then the textures missing the most detail
+        const auto priority = [state](u32 index) {
+            const StreamedTexture& texture = state->streaming.textures[index];
+            if (texture.requestedMip > texture.residentMip) return std::numeric_limits<i32>::min();
+            return (i32)texture.requestedMip - (i32)texture.residentMip;
+        };
+        std::sort(candidates.begin(), candidates.end(), [&](u32 a, u32 b) { return priority(a) < priority(b); });
+
+        u32 changes = 0;
+        for (u32 i : candidates) {
+            if (changes == config::renderer::STREAMING_UPLOADS_PER_FRAME) break;
+            const StreamedTexture& texture = state->streaming.textures[i];
+
+            if (texture.requestedMip > texture.residentMip) {
+                setResidency(state, i, texture.requestedMip);
+                state->streaming.evictions++;
+                changes++;
+                continue;
+            }
+
+            // settle for the most detailed level that still fits the budget
+            const usize current = residentSize(texture, texture.residentMip);
+            u32 mip = texture.requestedMip;
+            while (mip < texture.residentMip &&
+                   state->streaming.residentBytes - current + residentSize(texture, mip) > config::renderer::STREAMING_BUDGET)
+                mip++;
+            if (mip == texture.residentMip) continue;
+
+            setResidency(state, i, mip);
+            state->streaming.uploads++;
+            changes++;
+        }
+    }
+
+    // records this frame's residency changes and clears the feedback buffer before any draw writes to it
+    void record(RendererState* state, VkCommandBuffer cmd) {
+        PROFILE_ZONE("streaming record");
+        const AllocatedBuffer& feedback = state->streaming.feedback[state->frameNumber % config::renderer::FRAME_OVERLAP];
+        vkCmdFillBuffer(cmd, feedback.buffer, 0, VK_WHOLE_SIZE, 0);
+
+        auto& pending = state->streaming.pendingUploads;
+        if (!pending.empty()) {
+            // only levels more detailed than the previous image need to come from system memory
+            usize stagingSize = 0;
+            for (auto& upload : pending) {
+                const StreamedTexture& texture = state->streaming.textures[upload.texture];
+                for (u32 level = texture.residentMip; level < upload.previousMip; level++)
+                    stagingSize += texture.mipSizes[level];
+            }
+
+            AllocatedBuffer staging = {};
+            u8* data = nullptr;
+            if (stagingSize > 0) {
+                staging = vkres::createBuffer(state->allocator, stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+                data = (u8*)staging.allocation->GetMappedData();
+                deletion::retireBuffer(state, staging);
+            }
+
+            usize offset = 0;
+            for (auto& upload : pending) {
+                const StreamedTexture& texture = state->streaming.textures[upload.texture];
+                const AllocatedImage& image = state->textures[upload.texture].image;
+                vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+                vkutil::transitionImage(cmd, upload.previous.image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+                usize sourceOffset = 0;
+                for (u32 level = 0; level < texture.mipSizes.size(); level++) {
+                    if (level >= texture.residentMip && level < upload.previousMip) {
+                        VkBufferImageCopy copyRegion = {
+                            .bufferOffset = offset,
+                            .imageSubresource = {
+                                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                .mipLevel = level - texture.residentMip,
+                                .baseArrayLayer = 0,
+                                .layerCount = 1,
+                            },
+                            .imageExtent = { std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u), 1 },
+                        };
+                        memcpy(data + offset, texture.blocks.data() + sourceOffset, texture.mipSizes[level]);
+                        vkCmdCopyBufferToImage(cmd, staging.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+                        offset += texture.mipSizes[level];
+                    }
+                    else if (level >= texture.residentMip) {
+                        VkImageCopy copyRegion = {
+                            .srcSubresource = {
+                                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                .mipLevel = level - upload.previousMip,
+                                .baseArrayLayer = 0,
+                                .layerCount = 1,
+                            },
+                            .dstSubresource = {
+                                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                .mipLevel = level - texture.residentMip,
+                                .baseArrayLayer = 0,
+                                .layerCount = 1,
+                            },
+                            .extent = { std::max(texture.width >> level, 1u), std::max(texture.height >> level, 1u), 1 },
+                        };
+                        vkCmdCopyImage(cmd, upload.previous.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+                    }
+                    sourceOffset += texture.mipSizes[level];
+                }
+                vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+            }
+            pending.clear();
+        }
+
+        VkBufferMemoryBarrier2 barrier = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            .dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+            .buffer = feedback.buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        };
+        VkDependencyInfo depInfo = {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1,
+            .pBufferMemoryBarriers = &barrier,
+        };
+        vkCmdPipelineBarrier2(cmd, &depInfo);
+    }
+
+    // makes the feedback writes of this frame visible to the host once its fence signals
+    void finish(RendererState* state, VkCommandBuffer cmd) {
+        VkBufferMemoryBarrier2 barrier = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+            .srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT,
+            .dstAccessMask = VK_ACCESS_2_HOST_READ_BIT,
+            .buffer = state->streaming.feedback[state->frameNumber % config::renderer::FRAME_OVERLAP].buffer,
+            .offset = 0,
+            .size = VK_WHOLE_SIZE,
+        };
+        VkDependencyInfo depInfo = {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = 1,
+            .pBufferMemoryBarriers = &barrier,
+        };
+        vkCmdPipelineBarrier2(cmd, &depInfo);
+    }
+
+}
@@ -3,6 +3,8 @@
 #include "vkstructs.hpp"
 #include "helpers.hpp"
 #include "images.hpp"
+#include "descriptors.hpp"
+#include "deletion.hpp"
 
 namespace flux::renderer::swapchain {
 
@@ -14,15 +16,49 @@ namespace flux::renderer::swapchain {
         state->swapchainImageViews.clear();
     }
 
-    void create(RendererState* state, u32 width, u32 height) {
+    bool supportsPresentMode(const RendererState* state, VkPresentModeKHR mode) {
+        const auto& supported = state->pacing.supportedModes;
+        return std::find(supported.begin(), supported.end(), mode) != supported.end();
+    }
+
+    // the requested mode when supported, otherwise the closest one with the same intent: uncapped
+    // modes try each other before falling back to fifo, which every surface supports
+    VkPresentModeKHR selectPresentMode(RendererState* state, VkPresentModeKHR requested) {
+        u32 count = 0;
+        vkGetPhysicalDeviceSurfacePresentModesKHR(state->physicalDevice, state->surface, &count, nullptr);
+        state->pacing.supportedModes.resize(count);
+        vkGetPhysicalDeviceSurfacePresentModesKHR(state->physicalDevice, state->surface, &count, state->pacing.supportedModes.data());
+
+        std::array<VkPresentModeKHR, 2> fallbacks = { requested, requested };
+        if (requested == VK_PRESENT_MODE_MAILBOX_KHR) fallbacks[1] = VK_PRESENT_MODE_IMMEDIATE_KHR;
+        else if (requested == VK_PRESENT_MODE_IMMEDIATE_KHR) fallbacks[1] = VK_PRESENT_MODE_MAILBOX_KHR;
+        for (auto mode : fallbacks)
+            if (supportsPresentMode(state, mode)) return mode;
+        return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
+    // passing the old swapchain lets the driver reuse its resources and keeps it presenting until the
+    // new one takes over, the old swapchain is retired but must still be destroyed by the caller
+    void create(RendererState* state, u32 width, u32 height, VkSwapchainKHR oldSwapchain = VK_NULL_HANDLE) {
         auto swapchainBuilder = vkb::SwapchainBuilder{ state->physicalDevice, state->device, state->surface };
         state->swapchainImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
 
+        // only reported on the first swapchain or when the fallback changes, not on every rebuild
+        const VkPresentModeKHR previous = state->pacing.presentMode;
+        state->pacing.presentMode = selectPresentMode(state, state->pacing.requestedMode);
+        if (state->pacing.presentMode != state->pacing.requestedMode && (!state->swapchain || state->pacing.presentMode != previous))
+            log::warn(std::format("present mode {} unsupported, using {}",
+                string_VkPresentModeKHR(state->pacing.requestedMode), string_VkPresentModeKHR(state->pacing.presentMode)));
+        // present ids restart with every swapchain
+        state->pacing.presentId = 0;
+        state->pacing.completedId = 0;
+
         auto vkbSwapchain = swapchainBuilder
             .use_default_format_selection()
-            .set_desired_present_mode(VK_PRESENT_MODE_FIFO_KHR) // vsync
+            .set_desired_present_mode(state->pacing.presentMode)
             .set_desired_extent(width, height)
             .add_image_usage_flags(VK_IMAGE_USAGE_TRANSFER_DST_BIT)
+            .set_old_swapchain(oldSwapchain)
             .build()
             .value();
         
@@ -33,27 +69,55 @@ namespace flux::renderer::swapchain {
         state->swapchainImageViews = vkbSwapchain.get_image_views().value();
     }
 
-    void rebuild(RendererState* state) {
-        vkQueueWaitIdle(state->queue.graphics);
-        
-        // destroy swapchain & draw img
-        destroy(state);
-        vkDestroyImageView(state->device, state->drawImage.view, nullptr);
-        
-        state->availableDescriptorId.storageImage.emplace_back(state->drawImage.id);
+    //---------------------------------------------------
+    // |>~ RESIZE ~<|
+    //---------------------------------------------------
 
-        auto [w, h] = utility::getWindowSize(state->engine);
-        create(state, w, h);
+    // the depth image is created alongside and always has the draw image's extent
+    void createDrawImage(RendererState* state, u32 width, u32 height) {
         state->drawImage.image = vkres::createImage(
             state->allocator,
-            {w, h},
+            { width, height, 1 },
             VK_FORMAT_R16G16B16A16_SFLOAT,
             vkres::STORAGE_IMAGE_USES
         );
         state->drawImage.view = vkres::createImageView(state, state->drawImage.image);
         state->drawImage.id = descriptors::registerStorageImage(state, state->drawImage.view);
 
-        // TODO: update draw img descriptor here
+        state->depthImage.image = vkres::createImage(state->allocator, { width, height, 1 }, vkres::DEPTH_FORMAT, vkres::DEPTH_IMAGE_USES);
+        state->depthImage.view = vkres::createImageView(state, state->depthImage.image, VK_IMAGE_ASPECT_DEPTH_BIT);
+    }
+
+    // the draw image is allocated at the monitor size and only the window sized part is rendered, so it
+    // is reallocated only when the window outgrows it. the old image may still be in use by frames in
+    // flight and is retired to the deletion queue
+    void growDrawImage(RendererState* state, u32 width, u32 height) {
+        const VkExtent3D extent = state->drawImage.image.extent;
+        if (width <= extent.width && height <= extent.height) return;
+
+        log::debug(std::format("growing draw image to {}x{}", std::max(width, extent.width), std::max(height, extent.height)));
+        descriptors::unregister(state, state->drawImage.id);
+        deletion::retireImageView(state, state->drawImage.view);
+        deletion::retireImage(state, state->drawImage.image);
+        deletion::retireImageView(state, state->depthImage.view);
+        deletion::retireImage(state, state->depthImage.image);
+        createDrawImage(state, std::max(width, extent.width), std::max(height, extent.height));
+    }
+
+    // recreates the swapchain at the current window size without waiting for the queue. the retired
+    // swapchain and its views go to the deletion queue and are destroyed once this frame has completed,
+    // by then every frame that presented from them has completed too
+    void recreate(RendererState* state) {
+        auto [w, h] = utility::getWindowSize(state->engine);
+        if (w == 0 || h == 0) return; // minimised, keep the old swapchain until the window is restored
+        PROFILE_ZONE("swapchain recreate");
+
+        for (auto view : state->swapchainImageViews)
+            deletion::retireImageView(state, view);
+        deletion::retireSwapchain(state, state->swapchain);
+        create(state, w, h, state->swapchain);
+
+        growDrawImage(state, state->swapchainExtent.width, state->swapchainExtent.height);
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "../renderer.hpp"
+#include "helpers.hpp"
+#include "vkstructs.hpp"
+#include "images.hpp"
+#include "buffers.hpp"
+#include "descriptors.hpp"
+#include "bcn.hpp"
+
+// silence clang for external includes
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+    #include <stb/stb_image.h>
+#pragma clang diagnostic pop
+
+namespace flux::renderer::textures {
+
+    // how a texture is stored on the gpu. without compression rgba8 pixels are uploaded and mips
+    // are generated with blits, otherwise the cooked mip chain is uploaded as is
+    struct Encoding {
+        std::optional<bcn::Format> compression = bcn::Format::BC7;
+        bool srgb = true;
+
+        VkFormat vkFormat() const {
+            if (compression.has_value()) return bcn::vkFormat(compression.value(), srgb);
+            return srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+        }
+    };
+
+    // either decoded rgba8 pixels of mip 0 (owned by stb_image) or a block compressed mip chain
+    struct TextureData {
+        std::unique_ptr<u8[], void(*)(void*)> pixels = { nullptr, stbi_image_free };
+        std::vector<u8> blocks;         // every mip back to back, largest first
+        std::vector<u32> mipSizes;
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        u32 width = 0;
+        u32 height = 0;
+
+        bool valid() const { return pixels || !blocks.empty(); }
+        usize size() const { return pixels ? (usize)width * height * 4 : blocks.size(); }
+        // staging offsets must be a multiple of the texel block size (at most 16 bytes)
+        usize stagingSize() const { return (size() + 15) & ~(usize)15; }
+    };
+
+    // safe to call from worker threads
+    bool decode(std::span<const u8> bytes, TextureData* out, VkFormat format) {
+        i32 w, h, channels;
+        u8* pixels = stbi_load_from_memory(bytes.data(), (i32)bytes.size(), &w, &h, &channels, 4);
+        if (!pixels) return false;
+        out->pixels.reset(pixels);
+        out->format = format;
+        out->width = (u32)w;
+        out->height = (u32)h;
+        return true;
+    }
+
+    // 2x2 box filter down to 1x1, odd edges clamp. filtering happens on the stored values,
+    // so srgb textures are averaged in gamma space
+    std::vector<std::vector<u8>> buildMipChain(const u8* pixels, u32 width, u32 height) {
+        std::vector<std::vector<u8>> result;
+        result.emplace_back(pixels, pixels + (usize)width * height * 4);
+        while (width > 1 || height > 1) {
+            const std::vector<u8>& src = result.back();
+            const u32 w = std::max(width / 2, 1u), h = std::max(height / 2, 1u);
+            std::vector<u8> dst((usize)w * h * 4);
+            for (u32 y = 0; y < h; y++) {
+                const u32 y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                for (u32 x = 0; x < w; x++) {
+                    const u32 x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                    for (u32 c = 0; c < 4; c++) {
+                        const u32 sum = src[((usize)y0 * width + x0) * 4 + c] + src[((usize)y0 * width + x1) * 4 + c] +
+                                        src[((usize)y1 * width + x0) * 4 + c] + src[((usize)y1 * width + x1) * 4 + c];
+                        dst[((usize)y * w + x) * 4 + c] = (u8)((sum + 2) / 4);
+                    }
+                }
+            }
+            result.push_back(std::move(dst));
+            width = w;
+            height = h;
+        }
+        return result;
+    }
+
+    // builds the full mip chain on the cpu and block compresses every level, safe to call from worker threads
+    TextureData compress(const TextureData& decoded, bcn::Format compression, bool srgb) {
+        TextureData result = {
+            .format = bcn::vkFormat(compression, srgb),
+            .width = decoded.width,
+            .height = decoded.height,
+        };
+        u32 width = decoded.width, height = decoded.height;
+        for (auto& mip : buildMipChain(decoded.pixels.get(), decoded.width, decoded.height)) {
+            auto encoded = bcn::encode(compression, mip, width, height);
+            result.mipSizes.push_back((u32)encoded.size());
+            result.blocks.insert(result.blocks.end(), encoded.begin(), encoded.end());
+            width = std::max(width / 2, 1u);
+            height = std::max(height / 2, 1u);
+        }
+        return result;
+    }
+
+    // copies the levels from firstMip down of a compressed texture
+    TextureData mipTail(const TextureData& texture, u32 firstMip) {
+        usize offset = 0;
+        for (u32 level = 0; level < firstMip; level++)
+            offset += texture.mipSizes[level];
+        TextureData result = {
+            .blocks = std::vector<u8>(texture.blocks.begin() + (i64)offset, texture.blocks.end()),
+            .mipSizes = std::vector<u32>(texture.mipSizes.begin() + firstMip, texture.mipSizes.end()),
+            .format = texture.format,
+            .width = std::max(texture.width >> firstMip, 1u),
+            .height = std::max(texture.height >> firstMip, 1u),
+        };
+        return result;
+    }
+
+    // uploads textures through staging buffers of at most TEXTURE_STAGING_SIZE (a single larger texture
+    // gets its own batch) and registers each as a combined sampler. rgba8 textures get mips from a blit
+    // chain, compressed ones copy every cooked level. textures that failed to load keep CombinedSamplerId::INVALID
+    std::vector<CombinedSampler> upload(RendererState* state, std::span<const TextureData> textures) {
+        PROFILE_ZONE("texture upload");
+        std::vector<CombinedSampler> result(textures.size());
+
+        usize begin = 0;
+        while (begin < textures.size()) {
+            usize end = begin, batchSize = 0;
+            for (; end < textures.size(); end++) {
+                if (end > begin && batchSize + textures[end].stagingSize() > config::renderer::TEXTURE_STAGING_SIZE) break;
+                batchSize += textures[end].stagingSize();
+            }
+
+            AllocatedBuffer staging = vkres::createBuffer(state->allocator, std::max(batchSize, (usize)1),
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+            u8* data = (u8*)staging.allocation->GetMappedData();
+
+            std::vector<usize> offsets(end - begin);
+            usize offset = 0;
+            for (usize i = begin; i < end; i++) {
+                if (!textures[i].valid()) continue;
+                result[i].image = vkres::createImage(state->allocator,
+                    { textures[i].width, textures[i].height, 1 }, textures[i].format, vkres::TEXTURE_USES, true);
+                memcpy(data + offset, textures[i].pixels ? textures[i].pixels.get() : textures[i].blocks.data(), textures[i].size());
+                offsets[i - begin] = offset;
+                offset += textures[i].stagingSize();
+            }
+
+            vkutil::immediateSubmit(state, [&](VkCommandBuffer cmd) {
+                for (usize i = begin; i < end; i++) {
+                    if (!textures[i].valid()) continue;
+                    const AllocatedImage& image = result[i].image;
+                    vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+                    // one region per stored level, block compressed extents are in texels and may be smaller than a block
+                    std::vector<VkBufferImageCopy> copyRegions;
+                    const u32 levels = textures[i].pixels ? 1 : std::min((u32)textures[i].mipSizes.size(), image.mipLevels);
+                    usize levelOffset = offsets[i - begin];
+                    for (u32 level = 0; level < levels; level++) {
+                        copyRegions.push_back({
+                            .bufferOffset = levelOffset,
+                            .bufferRowLength = 0,
+                            .bufferImageHeight = 0,
+                            .imageSubresource = {
+                                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                                .mipLevel = level,
+                                .baseArrayLayer = 0,
+                                .layerCount = 1,
+                            },
+                            .imageExtent = { std::max(image.extent.width >> level, 1u), std::max(image.extent.height >> level, 1u), 1 },
+                        });
+                        if (!textures[i].pixels) levelOffset += textures[i].mipSizes[level];
+                    }
+                    vkCmdCopyBufferToImage(cmd, staging.buffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, (u32)copyRegions.size(), copyRegions.data());
+
+                    if (textures[i].pixels)
+                        vkutil::generateMipmaps(cmd, image.image, { image.extent.width, image.extent.height }, image.mipLevels);
+                    else
+                        vkutil::transitionImage(cmd, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                }
+            });
+            vkres::destroyBuffer(state->allocator, staging);
+
+            for (usize i = begin; i < end; i++) {
+                if (!textures[i].valid()) continue;
+                result[i].view = vkres::createImageView(state, result[i].image);
+                result[i].sampler = state->defaultSampler;
+                result[i].id = descriptors::registerCombinedSampler(state, result[i].view, result[i].sampler);
+                result[i].descriptorInfo = {
+                    .sampler = result[i].sampler,
+                    .imageView = result[i].view,
+                    .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                };
+            }
+            begin = end;
+        }
+        return result;
+    }
+
+    // sampler is shared (state->defaultSampler) and not destroyed here
+    void destroy(RendererState* state, const CombinedSampler& texture) {
+        if (texture.id == CombinedSamplerId::INVALID) return;
+        descriptors::unregister(state, texture.id);
+        vkDestroyImageView(state->device, texture.view, nullptr);
+        vkres::destroyImage(state->allocator, texture.image);
+    }
+
+}
@@ -56,12 +56,204 @@ namespace flux::renderer::ui {
         });
     }
 
+    // rows of scopes nested under parent, in first recorded order
+    void drawGpuScopes(const RendererState* state, u32 parent) {
+        const auto& stats = state->gpuProfiler.stats;
+        for (u32 i = 0; i < stats.size(); i++) {
+            if (stats[i].parent != parent) continue;
+            const bool leaf = std::none_of(stats.begin(), stats.end(), [i](const GpuScopeStats& s) { return s.parent == i; });
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            const bool open = ImGui::TreeNodeEx((void*)(usize)i, ImGuiTreeNodeFlags_DefaultOpen | ImGuiTreeNodeFlags_SpanFullWidth |
+                (leaf ? ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen : 0), "%s", stats[i].name);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats[i].last);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats[i].min);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats[i].avg);
+            ImGui::TableNextColumn(); ImGui::Text("%.3f", stats[i].p99);
+            if (open && !leaf) {
+                drawGpuScopes(state, i);
+                ImGui::TreePop();
+            }
+        }
+    }
+
+    // per pass work next to the draws and dispatches that caused it
+    void drawPipelineCounters(const RendererState* state) {
+        if (!ImGui::CollapsingHeader("pipeline statistics", ImGuiTreeNodeFlags_DefaultOpen)) return;
+        if (!state->gpuProfiler.pipelineStatistics) {
+            ImGui::Text("pipeline statistics queries not supported");
+            return;
+        }
+        if (!ImGui::BeginTable("counters", 9, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable)) return;
+
+        for (const char* column : { "pass", "draws", "dispatches", "ia prims", "vs invocations", "clip in", "clip out", "fs invocations", "cs invocations" })
+            ImGui::TableSetupColumn(column);
+        ImGui::TableHeadersRow();
+        for (const auto& stats : state->gpuProfiler.stats) {
+            if (!stats.pass) continue;
+            const auto& counters = stats.counters;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn(); ImGui::TextUnformatted(stats.name);
+            ImGui::TableNextColumn(); ImGui::Text("%u", counters.draws);
+            ImGui::TableNextColumn(); ImGui::Text("%u", counters.dispatches);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", counters.inputPrimitives);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", counters.vertexInvocations);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", counters.clippingInvocations);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", counters.clippingPrimitives);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", counters.fragmentInvocations);
+            ImGui::TableNextColumn(); ImGui::Text("%llu", counters.computeInvocations);
+        }
+        ImGui::EndTable();
+    }
+
+    void drawGpuProfiler(const RendererState* state) {
+        if (ImGui::Begin("gpu profiler")) {
+            if (!state->gpuProfiler.enabled) {
+                ImGui::Text("timestamps not supported");
+            } else if (ImGui::BeginTable("scopes", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_Resizable)) {
+                ImGui::TableSetupColumn("scope", ImGuiTableColumnFlags_NoHide);
+                ImGui::TableSetupColumn("ms");
+                ImGui::TableSetupColumn("min");
+                ImGui::TableSetupColumn("avg");
+                ImGui::TableSetupColumn("p99");
+                ImGui::TableHeadersRow();
+                drawGpuScopes(state, GpuScopeStats::ROOT);
+                ImGui::EndTable();
+            }
+            drawPipelineCounters(state);
+        }
+        ImGui::End();
+    }
+
+    // present mode, frame limiter and latency. mode changes are applied by pacing::update
+    void drawFramePacing(RendererState* state) {
+        auto& pacing = state->pacing;
+        if (ImGui::Begin("frame pacing")) {
+            if (ImGui::BeginCombo("present mode", string_VkPresentModeKHR(pacing.presentMode))) {
+                for (auto mode : pacing.supportedModes)
+                    if (ImGui::Selectable(string_VkPresentModeKHR(mode), mode == pacing.presentMode))
+                        pacing.requestedMode = mode;
+                ImGui::EndCombo();
+            }
+            ImGui::SliderFloat("fps limit", &pacing.fpsLimit, 0.f, 360.f, pacing.fpsLimit > 0.f ? "%.0f" : "off");
+            ImGui::BeginDisabled(!pacing.presentWait);
+            ImGui::Checkbox("low latency (present wait)", &pacing.lowLatency);
+            ImGui::EndDisabled();
+
+            ImGui::Text("input to %s latency: %.2f ms (avg %.2f, p99 %.2f)",
+                pacing.presentWait ? "present" : "present call", pacing.last, pacing.avg, pacing.p99);
+            ImGui::PlotLines("##latency", pacing.samples.data(), (i32)pacing.sampleCount, (i32)(pacing.sampleCount < config::renderer::LATENCY_HISTORY ? 0 : pacing.nextSample),
+                nullptr, 0.f, pacing.p99 * 1.5f, ImVec2(-1.f, 60.f));
+        }
+        ImGui::End();
+    }
+
+    void drawResolution(RendererState* state) {
+        auto& resolution = state->resolution;
+        if (ImGui::Begin("resolution")) {
+            ImGui::BeginDisabled(!state->gpuProfiler.enabled);
+            ImGui::Checkbox("dynamic", &resolution.enabled);
+            ImGui::EndDisabled();
+            if (resolution.enabled) {
+                ImGui::SliderFloat("gpu budget", &resolution.targetMs, 2.f, 50.f, "%.1f ms");
+                ImGui::Text("render scale: %.2f (gpu %.2f ms)", state->renderScale, resolution.gpuMs);
+            } else {
+                ImGui::SliderFloat("render scale", &state->renderScale, config::renderer::DYNAMIC_RESOLUTION_MIN_SCALE, 1.f, "%.2f");
+            }
+            ImGui::Text("draw extent: %ux%u of %ux%u", state->drawExtent.width, state->drawExtent.height,
+                state->swapchainExtent.width, state->swapchainExtent.height);
+        }
+        ImGui::End();
+    }
+
+#if FLUX_PROFILER
+    // one lane per thread, nested zones stacked by depth, scaled to the frame
+    void drawCpuProfiler(RendererState* state) {
+        auto& timeline = state->cpuTimeline;
+        if (!timeline.paused) {
+            std::tie(timeline.begin, timeline.end) = profiler::lastFrame();
+            timeline.zones = profiler::zones(timeline.begin, timeline.end);
+            timeline.threads = profiler::threadNames();
+        }
+
+        if (ImGui::Begin("cpu profiler")) {
+            ImGui::Checkbox("pause", &timeline.paused);
+            ImGui::SameLine();
+            if (ImGui::Button("export trace")) {
+                if (profiler::exportChromeTrace(config::profiler::TRACE_PATH))
+                    log::debug(std::format("wrote cpu trace to {}", config::profiler::TRACE_PATH.string()));
+                else
+                    log::warn(std::format("failed to write cpu trace to {}", config::profiler::TRACE_PATH.string()));
+            }
+            const f64 frameMs = (f64)(timeline.end - timeline.begin) * 1e-6;
+            ImGui::SameLine();
+            ImGui::Text("frame: %.3f ms", frameMs);
+
+            if (timeline.end > timeline.begin) {
+                const f32 rowHeight = ImGui::GetTextLineHeightWithSpacing();
+                const f32 labelWidth = 80.f;
+                const f32 width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 1.f);
+                const f32 scale = width / (f32)(timeline.end - timeline.begin);
+                ImDrawList* drawList = ImGui::GetWindowDrawList();
+
+                for (u32 thread = 0; thread < timeline.threads.size(); thread++) {
+                    u32 lanes = 0;
+                    for (const auto& zone : timeline.zones)
+                        if (zone.thread == thread) lanes = std::max(lanes, zone.depth + 1);
+                    if (lanes == 0) continue;
+
+                    const ImVec2 origin = ImGui::GetCursorScreenPos();
+                    drawList->AddText(origin, IM_COL32(200, 200, 200, 255), timeline.threads[thread].c_str());
+                    for (const auto& zone : timeline.zones) {
+                        if (zone.thread != thread) continue;
+                        const f32 x0 = origin.x + labelWidth + (f32)(std::max(zone.start, timeline.begin) - timeline.begin) * scale;
+                        const f32 x1 = origin.x + labelWidth + (f32)(std::min(zone.end, timeline.end) - timeline.begin) * scale;
+                        const f32 y0 = origin.y + (f32)zone.depth * rowHeight;
+                        const ImVec2 min = { x0, y0 }, max = { std::max(x1, x0 + 1.f), y0 + rowHeight - 1.f };
+
+                        const usize hash = std::hash<std::string_view>{}(zone.name);
+                        drawList->AddRectFilled(min, max, IM_COL32(80 + hash % 120, 80 + (hash >> 8) % 120, 80 + (hash >> 16) % 120, 255));
+                        if (max.x - min.x > ImGui::CalcTextSize(zone.name).x + 4.f)
+                            drawList->AddText({ min.x + 2.f, min.y }, IM_COL32(255, 255, 255, 255), zone.name);
+                        if (ImGui::IsMouseHoveringRect(min, max))
+                            ImGui::SetTooltip("%s: %.3f ms", zone.name, (f64)(zone.end - zone.start) * 1e-6);
+                    }
+                    ImGui::Dummy({ labelWidth + width, (f32)lanes * rowHeight + 4.f });
+                }
+            }
+        }
+        ImGui::End();
+    }
+#endif
+
     void startFrame(RendererState* state) {
         ImGui_ImplVulkan_NewFrame();
         ImGui_ImplGlfw_NewFrame();
 
 		ImGui::NewFrame();
 		ImGui::ShowDemoWindow();
+
+        if (ImGui::Begin("stats")) {
+            ImGui::Text("draws: %u", state->stats.drawCount);
+            ImGui::Text("binds: %u pipeline, %u index buffer, %u push constants", state->stats.pipelineBinds,
+                state->stats.indexBufferBinds, state->stats.pushConstantUpdates);
+            ImGui::Text("triangles: %llu", state->stats.triangleCount);
+            ImGui::Text("triangles saved by lod: %llu", state->stats.trianglesSavedByLod);
+            ImGui::Text("instances uploaded: %u / %zu", state->instanceBuffer.uploadedInstances, state->instances.size());
+            ImGui::Text("materials uploaded: %u / %zu", state->materials.uploadedMaterials, state->materials.data.size());
+            ImGui::Text("streamed textures: %.1f / %.1f mb", (f64)state->streaming.residentBytes / (1024.0 * 1024.0),
+                (f64)config::renderer::STREAMING_BUDGET / (1024.0 * 1024.0));
+            ImGui::Text("streaming uploads: %u, evictions: %u", state->streaming.uploads, state->streaming.evictions);
+        }
+        ImGui::End();
+        drawGpuProfiler(state);
+        drawFramePacing(state);
+        drawResolution(state);
+#if FLUX_PROFILER
+        drawCpuProfiler(state);
+#endif
+
 		ImGui::Render();
     }
 
@@ -83,6 +83,17 @@ namespace flux::renderer::vkstruct {
         };
     }
 
+    inline VkRenderingAttachmentInfo depthAttachmentInfo(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL) {
+        return {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+            .imageView = view,
+            .imageLayout = layout,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+            .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .clearValue = { .depthStencil = { .depth = 1.f } },
+        };
+    }
+
     inline VkRenderingInfo renderingInfo(VkExtent2D renderExtent, VkRenderingAttachmentInfo* color, VkRenderingAttachmentInfo* depth, VkRenderingAttachmentInfo* stencil) {
         return {
             .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
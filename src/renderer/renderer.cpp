@@ -1,4 +1,5 @@
 #define VMA_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
 #include "renderer.hpp"
 
 #include <core/engine.hpp>
@@ -8,9 +9,23 @@
 #include "internal/images.hpp"
 #include "internal/buffers.hpp"
 #include "internal/descriptors.hpp"
+#include "internal/deletion.hpp"
 #include "internal/swapchain.hpp"
+#include "internal/pacing.hpp"
 #include "internal/pipelines.hpp"
 #include "internal/shaders.hpp"
+#include "internal/hotreload.hpp"
+#include "internal/compute.hpp"
+#include "internal/meshes.hpp"
+#include "internal/textures.hpp"
+#include "internal/loader.hpp"
+#include "internal/streaming.hpp"
+#include "internal/instances.hpp"
+#include "internal/materials.hpp"
+#include "internal/draws.hpp"
+#include "internal/gpuprofiler.hpp"
+#include "internal/resolution.hpp"
+#include "internal/capture.hpp"
 #include "internal/ui.hpp"
 
 using namespace renderer;
@@ -25,10 +40,13 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
 }
 
 bool renderer::init(RendererState* state) {
-    // create instance
+    const bool headless = state->engine->options.headless;
+
+    // create instance, headless skips the surface extensions
     vkb::InstanceBuilder instanceBuilder;
     auto vkbInstance = instanceBuilder
         .set_app_name(config::APP_NAME.c_str())
+        .set_headless(headless)
         .request_validation_layers(config::renderer::ENABLE_VALIDATION_LAYERS)
         .set_debug_callback(debugCallback)
         .require_api_version(1, 3, 0)
@@ -43,7 +61,8 @@ bool renderer::init(RendererState* state) {
     });
 
     // create surface
-    VK_CHECK(glfwCreateWindowSurface(state->instance, state->engine->window, nullptr, &state->surface));
+    if (!headless)
+        VK_CHECK(glfwCreateWindowSurface(state->instance, state->engine->window, nullptr, &state->surface));
 
     // query physical device and create device
     auto physDevSelector = vkb::PhysicalDeviceSelector{ vkbInstance };
@@ -66,6 +85,7 @@ bool renderer::init(RendererState* state) {
             .descriptorBindingStorageBufferUpdateAfterBind = true,
             .descriptorBindingPartiallyBound = true,
             .runtimeDescriptorArray = true,
+            .timelineSemaphore = true,
             .bufferDeviceAddress = true,
         })
         .add_required_extensions({
@@ -80,6 +100,28 @@ bool renderer::init(RendererState* state) {
         .set_surface(state->surface)
         .select()
         .value();
+
+    // descriptor buffers are optional, fall back to the update after bind descriptor set when unsupported
+    state->descriptorBuffer.enabled = config::renderer::ENABLE_DESCRIPTOR_BUFFER
+        && vkbPhysDev.enable_extension_if_present(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)
+        && vkbPhysDev.enable_extension_features_if_present(VkPhysicalDeviceDescriptorBufferFeaturesEXT{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT,
+            .descriptorBuffer = true,
+        });
+    state->gpuProfiler.pipelineStatistics = config::renderer::ENABLE_PIPELINE_STATISTICS
+        && vkbPhysDev.enable_features_if_present({ .pipelineStatisticsQuery = true });
+    // present id + present wait are optional, they enable latency measurement to present completion
+    state->pacing.presentWait = !headless
+        && vkbPhysDev.enable_extension_if_present(VK_KHR_PRESENT_ID_EXTENSION_NAME)
+        && vkbPhysDev.enable_extension_if_present(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)
+        && vkbPhysDev.enable_extension_features_if_present(VkPhysicalDevicePresentIdFeaturesKHR{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR,
+            .presentId = true,
+        })
+        && vkbPhysDev.enable_extension_features_if_present(VkPhysicalDevicePresentWaitFeaturesKHR{
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR,
+            .presentWait = true,
+        });
     auto vkbDevice = vkb::DeviceBuilder{ vkbPhysDev }.build().value();
     state->device = vkbDevice.device;
     state->physicalDevice = vkbPhysDev.physical_device;
@@ -102,24 +144,29 @@ bool renderer::init(RendererState* state) {
         vmaDestroyAllocator(state->allocator);
     });
 
-    // get queues
+    // get queues, without a separate compute family compute uses the graphics queue
+    const auto computeQueue = vkbDevice.get_queue(vkb::QueueType::compute);
+    const auto computeIndex = vkbDevice.get_queue_index(vkb::QueueType::compute);
     state->queue = {
         .graphics = vkbDevice.get_queue(vkb::QueueType::graphics).value(),
-        .compute = vkbDevice.get_queue(vkb::QueueType::compute).value(),
+        .compute = computeQueue ? computeQueue.value() : vkbDevice.get_queue(vkb::QueueType::graphics).value(),
         .transfer = vkbDevice.get_queue(vkb::QueueType::transfer).value(),
     };
     state->queueFamily = {
         .graphics = vkbDevice.get_queue_index(vkb::QueueType::graphics).value(),
-        .compute = vkbDevice.get_queue_index(vkb::QueueType::compute).value(),
+        .compute = computeIndex ? computeIndex.value() : vkbDevice.get_queue_index(vkb::QueueType::graphics).value(),
         .transfer = vkbDevice.get_queue_index(vkb::QueueType::transfer).value(),
     };
     
     // init swapchain
+    pacing::init(state);
     auto [w, h] = utility::getWindowSize(state->engine);
-    swapchain::create(state, w, h);
-    state->deinitStack.emplace_back([state] {
-        swapchain::destroy(state);
-    });
+    if (!headless) {
+        swapchain::create(state, w, h);
+        state->deinitStack.emplace_back([state] {
+            swapchain::destroy(state);
+        });
+    }
 
     // init cmds
     auto cmdPoolInfo = vkstruct::cmdPoolCreateInfo(state->queueFamily.graphics, VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
@@ -157,45 +204,37 @@ bool renderer::init(RendererState* state) {
             vkDestroyFence(state->device, state->frames[i].renderFence, nullptr);
             vkDestroySemaphore(state->device, state->frames[i].renderSemaphore, nullptr);
             vkDestroySemaphore(state->device, state->frames[i].swapchainSemaphore, nullptr);
-            utility::flushDeinitStack(&state->frames[i].deinitStack);
         }
+        deletion::flush(state);
     });
 
     descriptors::init(state);
+    compute::init(state);
+    streaming::init(state);
+    gpuprofiler::init(state);
+    resolution::init(state);
     
-    // create draw image
-    //auto [ maxW, maxH ] = utility::getMonitorRes(state->engine);
-    state->drawImage.image = vkres::createImage(
-        state->allocator,
-        { w, h, 1 },
-        VK_FORMAT_R16G16B16A16_SFLOAT,
-        vkres::STORAGE_IMAGE_USES
-    );
-    state->drawImage.view = vkres::createImageView(state, state->drawImage.image);
-    state->drawImage.id = descriptors::registerStorageImage(state, state->drawImage.view);
+    // create draw image, windowed it covers the whole monitor so resizing rarely reallocates it
+    if (headless) {
+        swapchain::createDrawImage(state, w, h);
+    } else {
+        auto [maxW, maxH] = utility::getMonitorRes(state->engine);
+        swapchain::createDrawImage(state, std::max(w, maxW), std::max(h, maxH));
+    }
 	state->deinitStack.emplace_back([state] {
 		vkDestroyImageView(state->device, state->drawImage.view, nullptr);
         vkres::destroyImage(state->allocator, state->drawImage.image);
+        vkDestroyImageView(state->device, state->depthImage.view, nullptr);
+        vkres::destroyImage(state->allocator, state->depthImage.image);
 	});
 
-    // create pipeline
-    VkShaderModule fragShader = {};
-	if (!vkutil::loadShaderModule("zig-out/bin/res/shaders/coloredTriangle.frag.spv", state->device, &fragShader))
-        log::warn("error building triangle fragment shader module");
-	else
-        log::debug("triangle fragment shader succesfully loaded");
-    
-	VkShaderModule vertShader = {};
-	if (!vkutil::loadShaderModule("zig-out/bin/res/shaders/coloredTriangle.vert.spv", state->device, &vertShader))
-        log::warn("error building triangle vertex shader module");
-	else
-        log::debug("triangle vertex shader succesfully loaded");
-	
-    pipelines::initLayout(state, sizeof(GPUDrawPushConstants));
+    // create pipelines, rebuilt by hot reload whenever their shaders change
+    hotreload::init(state);
+    pipelines::initLayout(state);
 
     pipelines::PipelineBuilder pipelineBuilder;
 	pipelineBuilder.pipelineLayout = state->globalPipelineLayout;               // use global pipeline layout
-	pipelineBuilder.setShaders(vertShader, fragShader);                         // connect vert and frag shaders
+	pipelineBuilder.flags = descriptors::pipelineCreateFlags(state);            // descriptor buffer or set backend
 	pipelineBuilder.setInputTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);      // draw triangles
 	pipelineBuilder.setPolygonMode(VK_POLYGON_MODE_FILL);                       // filled triangles
 	pipelineBuilder.setCullMode(VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);    // no backface culling
@@ -203,15 +242,86 @@ bool renderer::init(RendererState* state) {
 	pipelineBuilder.disableBlending();                                          // no blending
 	pipelineBuilder.disableDepthtest();                                         // no depth testing
 	pipelineBuilder.setColorAttachmentFormat(state->drawImage.image.format);    // connect draw img format
-	pipelineBuilder.setDepthFormat(VK_FORMAT_UNDEFINED);                        // currently no depth img
-	state->pipeline = pipelineBuilder.build(state->device);             // build pipeline
-
-	// cleanup
-	vkDestroyShaderModule(state->device, fragShader, nullptr);
-	vkDestroyShaderModule(state->device, vertShader, nullptr);
+	pipelineBuilder.setDepthFormat(vkres::DEPTH_FORMAT);                        // connect depth img format
+    hotreload::buildPipeline(state, &state->pipeline, { "coloredTriangle.vert", "coloredTriangle.frag" }, {},
+        [state, builder = pipelineBuilder](std::span<const VkShaderModule> modules, std::span<const ShaderReflection> reflections) mutable {
+            builder.setShaders(modules[0], modules[1]);
+            return builder.build(state->device, reflections);
+        });
 	state->deinitStack.emplace_back([state] { vkDestroyPipeline(state->device, state->pipeline, nullptr); });
 
-    ui::init(state);
+    // create mesh pipelines, one per material feature combination. depth tested, so the front to back
+    // order of the draw sort lets hidden fragments be rejected early
+    pipelines::PipelineBuilder meshPipelineBuilder = pipelineBuilder;
+    meshPipelineBuilder.enableDepthtest(true, VK_COMPARE_OP_LESS_OR_EQUAL);
+    materials::buildPipelines(state, meshPipelineBuilder);
+
+    // create compute pipelines
+    compute::buildPipeline(state, &state->gradientPipeline, "gradient", GRADIENT_PUSH_CONSTANTS);
+    state->deinitStack.emplace_back([state] { compute::destroyPipeline(state, &state->gradientPipeline); });
+
+    // the background gradient overwrites the draw image, so geometry only waits for it at color output
+    compute::addTask(state, {
+        .name = "background",
+        .record = [state](VkCommandBuffer cmd) {
+            compute::dispatch(state, cmd, state->gradientPipeline,
+                GradientPushConstants{ .size = { state->drawExtent.width, state->drawExtent.height }, .image = state->drawImage.id },
+                state->drawExtent.width, state->drawExtent.height);
+        },
+        .resources = { {
+            .image = &state->drawImage.image.image,
+            .graphicsLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .graphicsStages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+            .graphicsAccess = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+        } },
+    });
+
+    // shared sampler for all textures
+    state->defaultSampler = vkres::createSampler(state);
+    state->deinitStack.emplace_back([state] { vkDestroySampler(state->device, state->defaultSampler, nullptr); });
+
+    // load scene meshes, textures and materials, benchmark runs generate a synthetic scene instead
+    materials::init(state);
+    const u32 firstMaterial = (u32)state->materials.data.size();
+    const auto& scene = state->engine->options.scene;
+    if (scene.meshes > 0) {
+        streaming::addTextures(state, vkutil::generateTextures(scene.textures, config::bench::SCENE_TEXTURE_SIZE));
+        for (const auto& texture : state->textures)
+            materials::add(state, { .baseColorTexture = texture.id });
+        state->meshes = vkutil::loadSyntheticMeshes(state, scene.meshes, scene.textures);
+        state->instances = vkutil::placeSyntheticInstances(state->meshes, std::max(scene.instances, scene.meshes));
+    } else {
+        if (std::filesystem::exists(config::renderer::SCENE_PATH)) {
+            if (auto loaded = vkutil::loadGltfMeshes(state, config::renderer::SCENE_PATH); loaded.has_value())
+                state->meshes = std::move(loaded.value());
+            else
+                log::warn(std::format("failed to load scene: {}", config::renderer::SCENE_PATH.string()));
+            streaming::addTextures(state, vkutil::readGltfTextures(config::renderer::SCENE_PATH));
+            for (const auto& material : vkutil::readGltfMaterials(config::renderer::SCENE_PATH, state->textures))
+                materials::add(state, material);
+        }
+        for (auto& mesh : state->meshes)
+            state->instances.push_back({ .mesh = mesh, .transform = glm::mat4(1.f) });
+    }
+    materials::assign(state->meshes, firstMaterial);
+    for (u32 i = 0; i < state->meshes.size(); i++)
+        state->meshes[i]->id = i;
+    instances::init(state);
+    state->deinitStack.emplace_back([state] {
+        for (auto& texture : state->textures)
+            textures::destroy(state, texture);
+        state->textures.clear();
+        state->streaming.textures.clear();
+        state->instances.clear();
+        for (auto& mesh : state->meshes) {
+            vkres::destroyBuffer(state->allocator, mesh->meshBuffers.indexBuffer);
+            vkres::destroyBuffer(state->allocator, mesh->meshBuffers.vertexBuffer);
+        }
+        state->meshes.clear();
+    });
+
+    capture::init(state);
+    if (!headless) ui::init(state);
 
     state->initialised = true;
     return true;
@@ -219,18 +329,22 @@ bool renderer::init(RendererState* state) {
 
 void renderer::deinit(RendererState* state) {
     vkDeviceWaitIdle(state->device);
+    capture::flush(state);
     utility::flushDeinitStack(&state->deinitStack);
     state->initialised = false;
 }
 
 void drawGeometry(RendererState* state, VkCommandBuffer cmd) {
+    PROFILE_ZONE("draw geometry");
     // begin a render pass with draw image
 	auto colorAttachment = vkstruct::attachmentInfo(state->drawImage.view, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    auto depthAttachment = vkstruct::depthAttachmentInfo(state->depthImage.view);
 
-	auto renderInfo = vkstruct::renderingInfo(state->drawExtent, &colorAttachment, nullptr, nullptr);
+	auto renderInfo = vkstruct::renderingInfo(state->drawExtent, &colorAttachment, &depthAttachment, nullptr);
 	vkCmdBeginRendering(cmd, &renderInfo);
 
 	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, state->pipeline);
+    state->stats.pipelineBinds++;
 
 	// set dynamic viewport
 	VkViewport viewport = {
@@ -255,82 +369,194 @@ void drawGeometry(RendererState* state, VkCommandBuffer cmd) {
 
 	// launch a draw command to draw 3 vertices
 	vkCmdDraw(cmd, 3, 1, 0, 0);
+    state->stats.drawCount++;
+
+    // draw scene meshes, picking a lod per instance from its projected error. draws are sorted by
+    // state so binds and push constants are only recorded when they change
+    const f32 pixelsPerUnit = (f32)state->drawExtent.height / (2.f * tanf(state->camera.fovY * .5f));
+    draws::build(state, pixelsPerUnit);
+    GPUDrawPushConstants pushConstants = {
+        .viewProjection = getViewProjection(state),
+        .feedbackBuffer = streaming::getFeedbackAddress(state),
+        .instanceBuffer = state->instanceBuffer.buffer.address,
+        .materialBuffer = state->materials.buffer.address,
+    };
+    vkCmdPushConstants(cmd, state->globalPipelineLayout, VK_SHADER_STAGE_ALL, 0, sizeof(GPUDrawPushConstants), &pushConstants);
+    state->stats.pushConstantUpdates++;
+    draws::record(state, cmd, &pushConstants);
+
 	vkCmdEndRendering(cmd);
 }
 
 void buildCommandBuffer(RendererState* state, VkCommandBuffer cmd, u32 swapchainImageIndex) {
 
-	//vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, state->globalPipelineLayout, 0, 1, &state->globalDescriptorSet, 0, nullptr);
-	//vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, state->globalPipelineLayout, 0, 1, &state->globalDescriptorSet, 0, nullptr);
-
     auto cmdBeginInfo = vkstruct::cmdBufferBeginInfo(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
-    state->drawExtent.width = state->drawImage.image.extent.width;
-    state->drawExtent.height = state->drawImage.image.extent.height;
-
     VK_CHECK(vkBeginCommandBuffer(cmd, &cmdBeginInfo));
     {
-        vkutil::transitionImage(cmd, state->drawImage.image.image,
-            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+        gpuprofiler::reset(state, cmd);
+        gpuprofiler::begin(state, cmd, "frame");
 
-        vkutil::transitionImage(cmd, state->drawImage.image.image,
-            VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        descriptors::bind(state, cmd, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        descriptors::bind(state, cmd, VK_PIPELINE_BIND_POINT_COMPUTE);
+
+        gpuprofiler::begin(state, cmd, "streaming");
+        streaming::record(state, cmd);
+        gpuprofiler::end(state, cmd);
+
+        gpuprofiler::begin(state, cmd, "instances");
+        instances::record(state, cmd);
+        materials::record(state, cmd);
+        gpuprofiler::end(state, cmd);
 
+        // leaves the draw image in COLOR_ATTACHMENT_OPTIMAL with the background drawn
+        compute::acquire(state, cmd);
+        // cleared on load, last frame's contents are never read
+        vkutil::transitionImage(cmd, state->depthImage.image.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL);
+
+        gpuprofiler::beginPass(state, cmd, "geometry");
         drawGeometry(state, cmd);
+        gpuprofiler::end(state, cmd);
 
-        // transtion the draw image and the swapchain image into their correct transfer layouts
         vkutil::transitionImage(cmd, state->drawImage.image.image,
             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-        vkutil::transitionImage(cmd, state->swapchainImages[swapchainImageIndex],
-            VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-        // execute a copy from the draw image into the swapchain
-	    vkutil::copyImageToImage(cmd, state->drawImage.image.image, state->swapchainImages[swapchainImageIndex], state->drawExtent, state->swapchainExtent);
-
-        // set swapchain image layout to Attachment Optimal so we can draw it
-        vkutil::transitionImage(cmd, state->swapchainImages[swapchainImageIndex],
-            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-        // draw imgui into the swapchain image
-        ui::draw(state, cmd, state->swapchainImageViews[swapchainImageIndex]);
+        if (state->engine->options.headless) {
+            // no swapchain, the draw image is the final output
+            gpuprofiler::begin(state, cmd, "capture");
+            capture::record(state, cmd);
+            gpuprofiler::end(state, cmd);
+        } else {
+            gpuprofiler::begin(state, cmd, "blit");
+            // transtion the swapchain image into its transfer layout
+            vkutil::transitionImage(cmd, state->swapchainImages[swapchainImageIndex],
+                VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+            // upscale the rendered part of the draw image into the swapchain
+            vkutil::copyImageToImage(cmd, state->drawImage.image.image, state->swapchainImages[swapchainImageIndex], state->drawExtent, state->swapchainExtent);
+            gpuprofiler::end(state, cmd);
+
+            // set swapchain image layout to Attachment Optimal so we can draw it
+            vkutil::transitionImage(cmd, state->swapchainImages[swapchainImageIndex],
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+            // draw imgui into the swapchain image
+            gpuprofiler::beginPass(state, cmd, "ui");
+            ui::draw(state, cmd, state->swapchainImageViews[swapchainImageIndex]);
+            gpuprofiler::end(state, cmd);
+
+            // set swapchain image layout to Present so we can draw it
+            vkutil::transitionImage(cmd, state->swapchainImages[swapchainImageIndex],
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        }
 
-        // set swapchain image layout to Present so we can draw it
-        vkutil::transitionImage(cmd, state->swapchainImages[swapchainImageIndex],
-            VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        streaming::finish(state, cmd);
+        compute::release(state, cmd);
+        gpuprofiler::end(state, cmd);
     }
 	VK_CHECK(vkEndCommandBuffer(cmd));
 }
 
+// headless runs orbit the origin at a fixed step per frame so every run sees the same views
+void updateHeadlessCamera(RendererState* state) {
+    const f32 angle = (f32)state->frameNumber * config::renderer::HEADLESS_ORBIT_STEP;
+    const f32 radius = Camera{}.position.z;
+    state->camera.yaw = angle;
+    state->camera.pitch = 0.f;
+    state->camera.position = { -radius * sinf(angle), 0.f, radius * cosf(angle) };
+}
+
+void renderer::pace(RendererState* state) {
+    pacing::wait(state);
+}
+
 void renderer::draw(RendererState* state) {
-    descriptors::updatePending(state);
-    ui::startFrame(state);
+    const bool headless = state->engine->options.headless;
 
-    // wait on gpu to finish rendering last frame
-    VK_CHECK(vkWaitForFences(state->device, 1, &getCurrentFrame(state).renderFence, true, 1000000000 /*max 1 second timeout*/));
-    VK_CHECK(vkResetFences(state->device, 1, &getCurrentFrame(state).renderFence));
+    // wait on gpu to finish rendering last frame, the fence is only reset once the frame will be submitted
+    {
+        PROFILE_ZONE("fence wait");
+        VK_CHECK(vkWaitForFences(state->device, 1, &getCurrentFrame(state).renderFence, true, 1000000000 /*max 1 second timeout*/));
+    }
 
-    utility::flushDeinitStack(&getCurrentFrame(state).deinitStack);
+    deletion::collect(state);
+    gpuprofiler::collect(state);
+    resolution::update(state);
+    capture::collect(state);
+    if (headless) updateHeadlessCamera(state);
+    pacing::update(state);
+    hotreload::poll(state);
 
     // request image from swapchain
-    u32 swapchainImageIndex;
-    VK_CHECK(vkAcquireNextImageKHR(
-        state->device, state->swapchain,
-        1000000000 /*max 1 second timeout*/,
-        getCurrentFrame(state).swapchainSemaphore,
-        nullptr, &swapchainImageIndex
-    ));
+    u32 swapchainImageIndex = 0;
+    if (!headless) {
+        PROFILE_ZONE("acquire");
+        const VkResult result = vkAcquireNextImageKHR(
+            state->device, state->swapchain,
+            1000000000 /*max 1 second timeout*/,
+            getCurrentFrame(state).swapchainSemaphore,
+            nullptr, &swapchainImageIndex
+        );
+        // the frame is skipped with its fence still signalled, the next call retries on the new swapchain
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            swapchain::recreate(state);
+            return;
+        }
+        if (result != VK_SUBOPTIMAL_KHR) VK_CHECK(result);
+    }
+
+    // only once the frame is known to be drawn, a skipped frame never starts an imgui frame
+    if (!headless) {
+        PROFILE_ZONE("ui");
+        ui::startFrame(state);
+    }
+    VK_CHECK(vkResetFences(state->device, 1, &getCurrentFrame(state).renderFence));
+
+    // residency changes swap descriptors, so they must be scheduled before pending writes are flushed
+    streaming::update(state);
+    descriptors::updatePending(state);
+
+    // windowed only the scaled swapchain sized corner of the draw image is rendered
+    state->drawExtent = resolution::drawExtent(state);
+    state->stats = {};
+
+    // async compute goes first so graphics can wait on it
+    compute::submit(state);
 
     auto cmd = getCurrentFrame(state).primaryCmdBuffer;
     VK_CHECK(vkResetCommandBuffer(cmd, 0));
 
-    buildCommandBuffer(state, cmd, swapchainImageIndex);
+    {
+        PROFILE_ZONE("record");
+        buildCommandBuffer(state, cmd, swapchainImageIndex);
+    }
     
-    // submit cmd buffer to queue to execute
+    // submit cmd buffer to queue to execute, headless has no swapchain to synchronise with
     auto cmdInfo = vkstruct::cmdBufferSubmitInfo(cmd);	
-	auto waitInfo = vkstruct::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, getCurrentFrame(state).swapchainSemaphore);
-	auto signalInfo = vkstruct::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, getCurrentFrame(state).renderSemaphore);
-	auto submitInfo = vkstruct::submitInfo(&cmdInfo, &signalInfo, &waitInfo);
-	VK_CHECK(vkQueueSubmit2(state->queue.graphics, 1, &submitInfo, getCurrentFrame(state).renderFence));
+    std::vector<VkSemaphoreSubmitInfo> waitInfos, signalInfos;
+    if (!headless) {
+        waitInfos.push_back(vkstruct::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR, getCurrentFrame(state).swapchainSemaphore));
+        signalInfos.push_back(vkstruct::semaphoreSubmitInfo(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, getCurrentFrame(state).renderSemaphore));
+    }
+    compute::addGraphicsSemaphores(state, &waitInfos, &signalInfos);
+    VkSubmitInfo2 submitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+        .waitSemaphoreInfoCount = (u32)waitInfos.size(),
+        .pWaitSemaphoreInfos = waitInfos.data(),
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &cmdInfo,
+        .signalSemaphoreInfoCount = (u32)signalInfos.size(),
+        .pSignalSemaphoreInfos = signalInfos.data(),
+    };
+    {
+        PROFILE_ZONE("submit");
+	    VK_CHECK(vkQueueSubmit2(state->queue.graphics, 1, &submitInfo, getCurrentFrame(state).renderFence));
+    }
+
+    if (headless) {
+        state->frameNumber++;
+        return;
+    }
 
     // prepare and present
 	VkPresentInfoKHR presentInfo = {
@@ -341,7 +567,23 @@ void renderer::draw(RendererState* state) {
         .pSwapchains = &state->swapchain,
         .pImageIndices = &swapchainImageIndex,
     };
-	VK_CHECK(vkQueuePresentKHR(state->queue.graphics, &presentInfo));
+    VkPresentIdKHR presentId;
+    pacing::prepare(state, &presentInfo, &presentId);
+    VkResult presentResult;
+    {
+        PROFILE_ZONE("present");
+	    presentResult = vkQueuePresentKHR(state->queue.graphics, &presentInfo);
+    }
+    pacing::presented(state);
+
+    // not every platform reports a resize through the present result, so the window size is checked too
+    auto [windowW, windowH] = utility::getWindowSize(state->engine);
+    if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR
+        || windowW != state->swapchainExtent.width || windowH != state->swapchainExtent.height) {
+        swapchain::recreate(state);
+    } else {
+        VK_CHECK(presentResult);
+    }
 
 	state->frameNumber++;
 }
@@ -4,6 +4,8 @@
 #include <subsystems/math.hpp>
 #include <subsystems/utility.hpp>
 #include <subsystems/log.hpp>
+#include <subsystems/profiler.hpp>
+#include <subsystems/jobs.hpp>
 
 // silence clang for external includes
 #pragma clang diagnostic push
@@ -19,12 +21,53 @@ namespace flux::config::renderer {
     static constexpr bool ENABLE_VALIDATION_LAYERS = true;
     static constexpr u32 FRAME_OVERLAP = 2;
     static constexpr u32 MAX_DESCRIPTOR_COUNT = std::numeric_limits<u16>::max(); // 65536
+    static constexpr u32 MAX_UNIFORM_BUFFER_COUNT = 16;     // update after bind uniform buffer limits are low
+    static constexpr bool ENABLE_DESCRIPTOR_BUFFER = true;  // use VK_EXT_descriptor_buffer when supported
     static constexpr u32 PUSH_CONSTANT_SIZE = 128;
+    static const std::filesystem::path SCENE_PATH = "res/meshes/scene.glb";
+    static const std::filesystem::path MESH_PACK_EXTENSION = ".fmesh";
+    static const std::filesystem::path TEXTURE_PACK_EXTENSION = ".ftex";
+    static constexpr u32 MAX_MESH_LODS = 6;
+    static constexpr f32 LOD_REDUCTION = 0.5f;              // target index count ratio between lods
+    static constexpr f32 LOD_MIN_REDUCTION = 0.9f;          // stop generating lods once a level saves less than this
+    static constexpr f32 LOD_MAX_SIMPLIFY_ERROR = 0.1f;     // relative to mesh extents
+    static constexpr f32 LOD_ERROR_THRESHOLD = 1.0f;        // max projected error in pixels
+    static constexpr u32 VERTEX_CACHE_SIZE = 16;            // used for vertex cache analysis
+    static constexpr f32 OVERDRAW_THRESHOLD = 1.05f;        // allowed acmr increase when optimizing overdraw
+    static constexpr usize TEXTURE_STAGING_SIZE = 64 * 1024 * 1024; // 64mb, per upload batch
+    static constexpr usize STREAMING_BUDGET = 256 * 1024 * 1024;    // 256mb, vram for streamed textures
+    static constexpr u32 STREAMING_RESIDENT_SIZE = 128;     // mips at or below this size never get evicted
+    static constexpr u32 STREAMING_UPLOADS_PER_FRAME = 8;   // residency changes applied per frame
+    static constexpr u32 STREAMING_EVICT_FRAMES = 120;      // unrequested frames before dropping to the resident tail
+    static constexpr u32 GPU_PROFILER_MAX_SCOPES = 64;      // timestamp scopes per frame
+    static constexpr u32 GPU_PROFILER_HISTORY = 240;        // frames of samples kept per scope for min/avg/p99
+    static constexpr bool ENABLE_PIPELINE_STATISTICS = true; // per pass pipeline statistics queries when supported
+    static constexpr f32 HEADLESS_ORBIT_STEP = 0.01f;       // radians per frame the headless camera orbits the origin
+    static constexpr u32 LATENCY_HISTORY = 240;            // frames of input to present latency kept for avg/p99
+    static constexpr u32 MAX_PENDING_PRESENTS = 8;          // presents tracked for latency until they complete
+    static constexpr u64 PRESENT_WAIT_TIMEOUT = 100000000;  // 100ms in ns, low latency wait gives up after this
+    static constexpr bool ENABLE_SHADER_HOT_RELOAD = true;  // watch SHADER_SOURCE_DIR and rebuild pipelines on change, not in headless runs
+    static const std::filesystem::path SHADER_SOURCE_DIR = "res/shaders";
+    static const std::filesystem::path SHADER_OUTPUT_DIR = "zig-out/bin/res/shaders";
+    static constexpr const char* SHADER_COMPILER = "slangc";
+    static constexpr f32 DYNAMIC_RESOLUTION_DEFAULT_MS = 16.6f; // gpu frame budget when enabled from the ui
+    static constexpr f32 DYNAMIC_RESOLUTION_HEADROOM = 0.9f;    // fraction of the budget the controller aims for
+    static constexpr f32 DYNAMIC_RESOLUTION_MIN_SCALE = 0.5f;   // per axis
+    static constexpr f32 DYNAMIC_RESOLUTION_MAX_STEP = 0.1f;    // largest scale change at once
+    static constexpr f32 DYNAMIC_RESOLUTION_DEADBAND = 0.03f;   // relative scale error that is ignored
+    static constexpr f32 DYNAMIC_RESOLUTION_SMOOTHING = 0.2f;   // weight of the newest gpu frame time
+    static constexpr u32 INSTANCE_BUFFER_MIN_CAPACITY = 1024;
+    static constexpr u32 INSTANCE_UPLOAD_MERGE_GAP = 4;     // clean instances between dirty ones copied along to save regions
+    static constexpr u32 MATERIAL_BUFFER_MIN_CAPACITY = 256;
+    static constexpr u32 DRAW_SORT_MIN_BLOCK = 4096;        // draw keys per radix sort job, fewer run on a single thread
+    static constexpr bool ENABLE_ASYNC_COMPUTE = true;      // run compute tasks on a separate compute queue family when there is one
 }
 
 namespace flux::renderer {
     bool init(RendererState* state);
     void deinit(RendererState* state);
+    // blocks until the next frame should start (present wait, frame limiter), call right before sampling input
+    void pace(RendererState* state);
     void draw(RendererState* state);
 
     struct FrameData {
@@ -32,19 +75,33 @@ namespace flux::renderer {
         VkCommandBuffer primaryCmdBuffer = nullptr;
         VkSemaphore swapchainSemaphore, renderSemaphore;
         VkFence renderFence = nullptr;
-        DeinitStack deinitStack = {};
+        // async compute, recorded on the compute queue family, see compute.hpp
+        VkCommandPool computeCmdPool = nullptr;
+        VkCommandBuffer computeCmdBuffer = nullptr;
+    };
+
+    // a resource waiting for the frames that may use it to complete, see deletion.hpp
+    enum class DeletionType : u8 { BUFFER, IMAGE, IMAGE_VIEW, SAMPLER, PIPELINE, SWAPCHAIN };
+    struct Deletion {
+        u64 handle = 0;                         // vulkan handle of type
+        VmaAllocation allocation = nullptr;     // buffers and images only
+        usize frame = 0;                        // frame that retired it
+        DeletionType type = {};
     };
 
-    enum class UniformBufferId : u32            { INVALID = 16 };
+    enum class UniformBufferId : u32            { INVALID = config::renderer::MAX_UNIFORM_BUFFER_COUNT };
     enum class CombinedSamplerId : u32          { INVALID = std::numeric_limits<u16>::max() };
     enum class StorageImageId : u32             { INVALID = std::numeric_limits<u16>::max() };
     enum class AccelerationStructureId : u32    { INVALID = std::numeric_limits<u16>::max() };
+    enum class StorageBufferId : u32            { INVALID = std::numeric_limits<u16>::max() };
 
     enum class Binding : u8 {
         UNIFORM_BUFFER          = 0,
         COMBINED_SAMPLER        = 1,
         STORAGE_IMAGE           = 2,
         ACCELERATION_STRUCTURE  = 3,
+        STORAGE_BUFFER          = 4,
+        COUNT,
     };
 
     struct AllocatedBuffer {
@@ -53,11 +110,19 @@ namespace flux::renderer {
         VmaAllocationInfo info = {};
     };
 
+    // device local array read through buffer device address, see vkres::upload
+    struct ResidentBuffer {
+        AllocatedBuffer buffer = {};
+        VkDeviceAddress address = 0;
+        usize capacity = 0;             // in bytes
+    };
+
     struct AllocatedImage {
         VkImage image = nullptr;
         VmaAllocation allocation = nullptr;
         VkExtent3D extent = {};
         VkFormat format = {};
+        u32 mipLevels = 1;
     };
 
     struct CombinedSampler {
@@ -74,6 +139,67 @@ namespace flux::renderer {
         StorageImageId id = StorageImageId::INVALID;
     };
 
+    // system memory copy of a cooked texture and the part of its mip chain resident on the gpu
+    struct StreamedTexture {
+        std::vector<u8> blocks;         // full block compressed mip chain
+        std::vector<u32> mipSizes;
+        u32 width = 0;
+        u32 height = 0;
+        u32 residentMip = 0;            // most detailed level on the gpu
+        u32 tailMip = 0;                // first level of the always resident tail
+        u32 requestedMip = 0;           // from the latest feedback
+        usize lastRequestedFrame = 0;
+    };
+
+    // residency change recorded at the start of the frame, levels shared with the previous image are copied on the gpu
+    struct StreamingUpload {
+        u32 texture;
+        u32 previousMip;
+        AllocatedImage previous;
+    };
+
+    // pipeline statistics of a pass next to the draws and dispatches recorded in it
+    struct PipelineCounters {
+        u64 inputPrimitives = 0;
+        u64 vertexInvocations = 0;
+        u64 clippingInvocations = 0;    // primitives reaching the clipper
+        u64 clippingPrimitives = 0;     // primitives leaving it
+        u64 fragmentInvocations = 0;
+        u64 computeInvocations = 0;
+        u32 draws = 0;
+        u32 dispatches = 0;
+    };
+
+    // timestamp pair recorded this frame, see gpuprofiler.hpp
+    struct GpuScope {
+        u32 stat;       // index into the profiler's scope stats
+        u32 query;      // begin query, end is query + 1
+        u32 statisticsQuery = NO_QUERY; // only for passes
+        u32 draws = 0;                  // recorded draws/dispatches when the pass began, then the count within it
+        u32 dispatches = 0;
+
+        static constexpr u32 NO_QUERY = std::numeric_limits<u32>::max();
+    };
+
+    // rolling timings of a named scope, identified by its name and parent
+    struct GpuScopeStats {
+        const char* name;
+        u32 parent;     // index of the enclosing scope or GpuScopeStats::ROOT
+        u32 depth;
+        std::array<f32, config::renderer::GPU_PROFILER_HISTORY> samples = {}; // ms, ring buffer
+        u32 sampleCount = 0;
+        u32 nextSample = 0;
+        f32 last = 0.f;
+        f32 min = 0.f;
+        f32 avg = 0.f;
+        f32 p99 = 0.f;
+        bool pass = false;
+        PipelineCounters counters = {}; // latest, passes only
+
+        static constexpr u32 ROOT = std::numeric_limits<u32>::max();
+    };
+
+    // full precision vertex, only used on the cpu during import/cooking
     struct Vertex {
         glm::vec3 position;
         f32 uv_x;
@@ -82,6 +208,15 @@ namespace flux::renderer {
         glm::vec4 color;
     };
 
+    // quantized vertex as stored in mesh packs and on the gpu, see meshes::quantize
+    struct PackedVertex {
+        glm::vec3 position;
+        i16 normal[2];  // octahedral, snorm16
+        u16 uv[2];      // half float
+        u32 color;      // rgba8 unorm
+    };
+    static_assert(sizeof(PackedVertex) == 24);
+
     // holds the resources needed for a mesh
     struct GPUMeshBuffers {
         AllocatedBuffer indexBuffer;
@@ -89,27 +224,163 @@ namespace flux::renderer {
         VkDeviceAddress vertexBufferAddress;
     };
 
-    // push constants for mesh object draws
+    // per instance data in the gpu resident instance buffer, see instances.hpp
+    struct GPUInstance {
+        glm::mat4 transform;
+        glm::mat4 previousTransform;    // as of the last frame, equal to transform while not moving
+        glm::vec4 bounds;               // world space bounding sphere, xyz = center, w = radius
+        u32 material;                   // override of the surface materials or NO_MATERIAL, not an index by itself
+        u32 padding[3];
+    };
+    static_assert(sizeof(GPUInstance) == 160);
+
+    // material feature bits, every combination is its own mesh pipeline permutation, see materials.hpp
+    enum MaterialFeature : u32 {
+        MATERIAL_TEXTURED = 1 << 0,         // set from baseColorTexture
+        MATERIAL_ALPHA_TEST = 1 << 1,
+        MATERIAL_DOUBLE_SIDED = 1 << 2,
+    };
+    static constexpr u32 MATERIAL_PERMUTATIONS = 1 << 3;
+
+    // one slot of the gpu resident material table, indexed by material id
+    struct GPUMaterial {
+        glm::vec4 baseColor = glm::vec4(1.f);
+        CombinedSamplerId baseColorTexture = CombinedSamplerId::INVALID;
+        f32 alphaCutoff = 0.5f;             // MATERIAL_ALPHA_TEST only
+        u32 features = 0;
+        u32 padding = 0;
+    };
+    static_assert(sizeof(GPUMaterial) % 16 == 0);
+
+    // push constants for mesh object draws, per frame members first so draws only push the tail
     struct GPUDrawPushConstants {
-        glm::mat4 worldMatrix;
+        glm::mat4 viewProjection;
+        VkDeviceAddress feedbackBuffer; // streaming feedback, see streaming.hpp
+        VkDeviceAddress instanceBuffer;
+        VkDeviceAddress materialBuffer;
         VkDeviceAddress vertexBuffer;
+        u32 instance;
+        u32 material;
+    };
+
+    // c++ side of a push constant block, checked against the reflected block of every shader using it
+    struct PushConstantLayout {
+        u32 size = 0;                   // 0 only checks against the layout range
+        std::vector<u32> offsets = {};  // per member, in declaration order
+        std::vector<u32> strides = {};  // per member, element size behind buffer address members, 0 skips the check
+    };
+    static const PushConstantLayout DRAW_PUSH_CONSTANTS = {
+        .size = sizeof(GPUDrawPushConstants),
+        .offsets = {
+            (u32)offsetof(GPUDrawPushConstants, viewProjection),
+            (u32)offsetof(GPUDrawPushConstants, feedbackBuffer),
+            (u32)offsetof(GPUDrawPushConstants, instanceBuffer),
+            (u32)offsetof(GPUDrawPushConstants, materialBuffer),
+            (u32)offsetof(GPUDrawPushConstants, vertexBuffer),
+            (u32)offsetof(GPUDrawPushConstants, instance),
+            (u32)offsetof(GPUDrawPushConstants, material),
+        },
+        .strides = { 0, sizeof(u32), sizeof(GPUInstance), sizeof(GPUMaterial), sizeof(PackedVertex), 0, 0 },
+    };
+
+    // push constants for the gradient background pass
+    struct GradientPushConstants {
+        glm::uvec2 size;                // rendered part of the image
+        StorageImageId image;
+    };
+    static const PushConstantLayout GRADIENT_PUSH_CONSTANTS = {
+        .size = sizeof(GradientPushConstants),
+        .offsets = { (u32)offsetof(GradientPushConstants, size), (u32)offsetof(GradientPushConstants, image) },
     };
 
+    // what loadShaderModule reflects from spir-v, see reflection.hpp
+    struct ShaderReflection {
+        VkShaderStageFlagBits stage = {};
+        u32 pushConstantSize = 0;
+        std::vector<u32> pushConstantOffsets = {};
+        std::vector<u32> pushConstantStrides = {};                      // array stride of buffer address members, 0 for others
+        std::array<u32, 3> workgroupSize = {};                          // compute, task and mesh shaders
+        std::array<u32, 3> workgroupSizeSpecIds = { ~0u, ~0u, ~0u };    // set where a dimension is a specialization constant
+        struct Descriptor {
+            u32 set;
+            u32 binding;
+            Binding kind;               // COUNT when the global layout has no binding of the type
+        };
+        std::vector<Descriptor> descriptors = {};
+        struct SpecConstant {
+            u32 id;
+            u32 size;
+        };
+        std::vector<SpecConstant> specConstants = {};
+    };
+
+    // a compute pipeline with the workgroup size reflected from its shader, see compute.hpp
+    struct ComputePipeline {
+        VkPipeline pipeline = nullptr;
+        std::array<u32, 3> workgroupSize = { 1, 1, 1 };
+    };
+
+    static constexpr u32 NO_TEXTURE = std::numeric_limits<u32>::max();
+    static constexpr u32 NO_MATERIAL = std::numeric_limits<u32>::max();
+    static constexpr u32 DEFAULT_MATERIAL = 0;      // untextured white, always present
+
     struct GeoSurface {
         u32 startIndex;
         u32 count;
+        u32 material;     // index into the source's materials or NO_MATERIAL, material ids once loaded
+    };
+
+    // simplified level of a mesh, surfaces index into the same buffers as the full detail surfaces
+    struct MeshLod {
+        std::vector<GeoSurface> surfaces;
+        f32 error; // object space simplification error
     };
 
     struct MeshAsset {
         std::string name;
         std::vector<GeoSurface> surfaces;
+        std::vector<MeshLod> lods;  // increasingly coarse, excludes full detail
+        glm::vec4 bounds;           // object space bounding sphere, xyz = center, w = radius
         GPUMeshBuffers meshBuffers;
+        u32 id = 0;                 // index in state->meshes, groups draws that share buffers
+    };
+
+    // cpu side of an instance, its index is its slot in the instance buffer. change through instances.hpp
+    struct MeshInstance {
+        std::shared_ptr<MeshAsset> mesh;
+        glm::mat4 transform;
+        u32 material = NO_MATERIAL;     // overrides the surface materials when set
+    };
+
+    // one surface of an instance at its selected lod, rebuilt every frame
+    struct DrawCommand {
+        const MeshAsset* mesh;
+        u32 instance;
+        u32 material;
+        u32 startIndex;
+        u32 count;
+        u32 trianglesSavedByLod;
+    };
+
+    // draws are recorded in key order, see draws.hpp for the layout
+    struct DrawKey {
+        u64 key;
+        u32 draw;   // index into the frame's draw commands
+    };
+
+    struct Camera {
+        glm::vec3 position = { 0.f, 0.f, 5.f };
+        f32 pitch = 0.f;
+        f32 yaw = 0.f;
+        f32 fovY = glm::radians(70.f);
+        f32 nearPlane = 0.1f;
+        f32 farPlane = 10000.f;
     };
 
     struct RendererState {
         const EngineState* engine;
         bool initialised = false;
-        f32 renderScale = 1.0f;
+        f32 renderScale = 1.0f;                 // per axis, fraction of the swapchain extent that is rendered
 
         VkInstance instance = nullptr;
         VkDebugUtilsMessengerEXT debugMessenger = nullptr;
@@ -134,6 +405,25 @@ namespace flux::renderer {
         VkDescriptorPool globalDescriptorPool = nullptr;
         VkDescriptorPool imguiDescriptorPool = nullptr;
 
+        // VK_EXT_descriptor_buffer backend for the global set, replaces the pool and set when enabled.
+        // every frame slot has its own copy of the set, so rewrites never touch one a frame in flight reads
+        struct {
+            bool enabled = false;
+            AllocatedBuffer buffer = {};
+            VkDeviceAddress address = 0;
+            u8* mapped = nullptr;
+            VkDeviceSize slotSize = 0;      // one copy of the set layout, rounded up to descriptorBufferOffsetAlignment
+            std::array<VkDeviceSize, (usize)Binding::COUNT> bindingOffsets = {};
+            std::array<usize, (usize)Binding::COUNT> descriptorSizes = {};
+            PFN_vkGetDescriptorSetLayoutSizeEXT getLayoutSize = nullptr;
+            PFN_vkGetDescriptorSetLayoutBindingOffsetEXT getBindingOffset = nullptr;
+            PFN_vkGetDescriptorEXT getDescriptor = nullptr;
+            PFN_vkCmdBindDescriptorBuffersEXT cmdBindBuffers = nullptr;
+            PFN_vkCmdSetDescriptorBufferOffsetsEXT cmdSetOffsets = nullptr;
+            PFN_vkGetAccelerationStructureDeviceAddressKHR getAccelerationStructureAddress = nullptr;
+        } descriptorBuffer = {};
+
+        // bindless id allocation per binding, see descriptors.hpp
         struct {
             u32 uniformBuffer = 0;
             u32 storageBuffer = 0;
@@ -145,25 +435,212 @@ namespace flux::renderer {
         // lists of deleted/newly available descriptor ids
         struct {
             std::vector<UniformBufferId> uniformBuffer = {};
+            std::vector<StorageBufferId> storageBuffer = {};
             std::vector<CombinedSamplerId> combinedSampler = {};
             std::vector<StorageImageId> storageImage = {};
             std::vector<AccelerationStructureId> accelerationStructure = {};
         } availableDescriptorId = {};
-        
-        struct PendingWriteDescriptors {
-            union DescriptorInfo { VkDescriptorImageInfo image; VkDescriptorBufferInfo buffer; };
-            std::vector<VkWriteDescriptorSet> write = {};
-            std::vector<DescriptorInfo> info = {};
-        } pendingWriteDescriptors = {};
-        
+
+        // unregistered ids, only recycled once every frame that could still use them has retired
+        struct RetiredDescriptorId {
+            Binding binding;
+            u32 id;
+            usize frame;
+        };
+        std::vector<RetiredDescriptorId> retiredDescriptorIds = {};
+
+        // retired resources in frame order
+        std::vector<Deletion> deletionQueue = {};
+
+        // writes are stored by value and only turned into VkWriteDescriptorSets when flushed
+        struct PendingWriteDescriptor {
+            Binding binding;
+            u32 element;
+            u32 slots = 0;  // descriptor buffer backend: frame slots whose copy is still missing the write
+            union {
+                VkDescriptorImageInfo image;
+                VkDescriptorBufferInfo buffer;
+                VkAccelerationStructureKHR accelerationStructure;
+            };
+        };
+        std::vector<PendingWriteDescriptor> pendingWriteDescriptors = {};
+
         std::vector<VkImage> swapchainImages = {};
         std::vector<VkImageView> swapchainImageViews = {};
 
         StorageImage drawImage = {};
-        StorageImage depthStencil = {};
+        struct { AllocatedImage image = {}; VkImageView view = nullptr; } depthImage = {};  // same extent as the draw image
 
         VkPipelineLayout globalPipelineLayout = nullptr;
-        VkPipeline pipeline;
+        VkPipeline pipeline = nullptr;
+        std::array<VkPipeline, MATERIAL_PERMUTATIONS> meshPipelines = {};   // by material features
+        ComputePipeline gradientPipeline = {};
+
+        Camera camera = {};
+        std::vector<std::shared_ptr<MeshAsset>> meshes = {};
+        std::vector<MeshInstance> instances = {};
+
+        // material table, ids index data and the gpu copy, see materials.hpp
+        struct {
+            ResidentBuffer buffer = {};
+            std::vector<GPUMaterial> data = {};
+            std::vector<u32> dirty = {};        // changed since the last upload, unsorted with duplicates
+            u32 uploadedMaterials = 0;          // last frame
+        } materials = {};
+
+        // gpu resident copy of instances, only dirty ranges are uploaded, see instances.hpp
+        struct {
+            ResidentBuffer buffer = {};
+            std::vector<GPUInstance> data = {}; // as last uploaded
+            std::vector<u32> dirty = {};        // changed since the last upload, unsorted with duplicates
+            std::vector<u32> moving = {};       // transform set since the last upload, unsorted with duplicates
+            std::vector<u32> moved = {};        // moved in the last upload, their previous transform catches up
+            u32 uploadedInstances = 0;          // last frame
+        } instanceBuffer = {};
+
+        // this frame's draws and their sorted keys, see draws.hpp
+        struct {
+            std::vector<DrawCommand> commands = {};
+            std::vector<DrawKey> keys = {};
+            std::vector<DrawKey> scratch = {};  // radix sort ping pong
+        } draws = {};
+        std::vector<CombinedSampler> textures = {};
+        VkSampler defaultSampler = nullptr;
+
+        // streamed textures index parallel to textures, entries without blocks are fully resident
+        struct {
+            std::vector<StreamedTexture> textures = {};
+            AllocatedBuffer feedback[config::renderer::FRAME_OVERLAP] = {};
+            VkDeviceAddress feedbackAddress[config::renderer::FRAME_OVERLAP] = {};
+            std::vector<StreamingUpload> pendingUploads = {};
+            usize residentBytes = 0;
+            u32 uploads = 0;
+            u32 evictions = 0;
+        } streaming = {};
+
+        // timestamp queries per frame in flight, read back once the frame's fence has signalled
+        struct {
+            bool enabled = false;
+            VkQueryPool queryPools[config::renderer::FRAME_OVERLAP] = {};
+            bool pipelineStatistics = false;
+            VkQueryPool statisticsPools[config::renderer::FRAME_OVERLAP] = {};
+            bool statisticsActive = false;      // pipeline statistics queries of a type cannot overlap
+            std::vector<GpuScope> scopes[config::renderer::FRAME_OVERLAP] = {};
+            std::vector<u32> open = {};         // stack of open scope indices into the current frame's scopes
+            std::vector<GpuScopeStats> stats = {};
+            f64 timestampPeriod = 0.0;          // ns per tick
+            u64 timestampMask = 0;              // valid bits of the graphics queue timestamps
+        } gpuProfiler = {};
+
+        // last completed frame's cpu zones for the ui timeline, kept while paused
+        struct {
+            bool paused = false;
+            u64 begin = 0;
+            u64 end = 0;
+            std::vector<profiler::ZoneRecord> zones = {};
+            std::vector<std::string> threads = {};
+        } cpuTimeline = {};
+
+        // headless readback of the draw image per frame in flight, see capture.hpp
+        struct {
+            AllocatedBuffer readback[config::renderer::FRAME_OVERLAP] = {};
+            bool pending[config::renderer::FRAME_OVERLAP] = {};
+            usize frame[config::renderer::FRAME_OVERLAP] = {};
+        } capture = {};
+
+        // present mode, frame limiter and input to present latency, see pacing.hpp
+        struct {
+            VkPresentModeKHR requestedMode = VK_PRESENT_MODE_FIFO_KHR;
+            VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;    // active, after fallback
+            std::vector<VkPresentModeKHR> supportedModes = {};
+            f32 fpsLimit = 0.f;                                         // 0 is unlimited
+            std::chrono::steady_clock::time_point nextFrame = {};
+
+            // VK_KHR_present_id + VK_KHR_present_wait, latency is measured to present completion when
+            // available and to the present call otherwise
+            bool presentWait = false;
+            bool lowLatency = false;
+            PFN_vkWaitForPresentKHR waitForPresent = nullptr;
+            u64 presentId = 0;                                          // last id presented on this swapchain
+            u64 completedId = 0;                                        // last id known to be on screen
+            std::chrono::steady_clock::time_point inputTime = {};       // when this frame's input was sampled
+            std::array<std::chrono::steady_clock::time_point, config::renderer::MAX_PENDING_PRESENTS> presentInputTimes = {};
+
+            // input to present latency in ms
+            std::array<f32, config::renderer::LATENCY_HISTORY> samples = {};
+            u32 sampleCount = 0;
+            u32 nextSample = 0;
+            f32 last = 0.f;
+            f32 avg = 0.f;
+            f32 p99 = 0.f;
+        } pacing = {};
+
+        // shader hot reload, see hotreload.hpp
+        struct ReloadablePipeline {
+            VkPipeline* pipeline;
+            std::vector<std::string> shaders;   // compiled shader names without extension, e.g. "mesh.vert"
+            PushConstantLayout pushConstants;
+            std::function<VkPipeline(std::span<const VkShaderModule> modules, std::span<const ShaderReflection> reflections)> build;
+            std::vector<ShaderReflection> reflections = {};   // of the shaders the current pipeline was built from
+        };
+        struct ShaderCompile {
+            std::string shader;
+            jobs::Counter done;
+            bool succeeded = false;
+            bool again = false;                 // the source changed again while compiling
+            std::string output;                 // compiler messages
+        };
+        struct {
+            bool enabled = false;
+            i32 inotify = -1;
+            std::vector<ReloadablePipeline> pipelines = {};
+            std::vector<std::unique_ptr<ShaderCompile>> compiles = {};
+        } shaderReload = {};
+
+        // dynamic resolution controller, see resolution.hpp
+        struct {
+            bool enabled = false;
+            f32 targetMs = 0.f;             // gpu frame time budget
+            f32 gpuMs = 0.f;                // smoothed, 0 until measured at the current scale
+            u32 settleFrames = 0;           // frames left before timings reflect the current scale
+        } resolution = {};
+
+        // compute tasks that overlap graphics on the async compute queue, see compute.hpp
+        struct AsyncComputeResource {
+            const VkBuffer* buffer = nullptr;                   // either a buffer or a color image, pointed to so
+            const VkImage* image = nullptr;                     // recreated ones like the draw image stay tracked
+            VkImageLayout computeLayout = VK_IMAGE_LAYOUT_GENERAL;
+            VkImageLayout graphicsLayout = VK_IMAGE_LAYOUT_UNDEFINED;   // handed to graphics in and expected back in at frame end
+            VkPipelineStageFlags2 graphicsStages = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            VkAccessFlags2 graphicsAccess = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+            bool preserve = false;                              // keep the contents graphics left, otherwise they are discarded
+        };
+        struct AsyncComputeTask {
+            const char* name;
+            std::function<void(VkCommandBuffer cmd)> record;
+            std::vector<AsyncComputeResource> resources;        // everything the task writes or reads that graphics also uses
+            bool ready = false;                                 // preserved resources were released by graphics
+            bool scheduled = false;                             // submitted this frame
+        };
+        struct {
+            bool enabled = false;                   // a separate compute queue family exists, otherwise tasks run inline on graphics
+            VkSemaphore timeline = nullptr;         // signalled by both queues in submission order
+            u64 value = 0;                          // last value submitted
+            u64 graphicsValue = 0;                  // last value signalled by graphics
+            u64 computeValue = 0;                   // this frame's compute submission, 0 without one
+            std::vector<AsyncComputeTask> tasks = {};
+        } asyncCompute = {};
+
+        // per frame draw statistics, reset when recording starts
+        struct {
+            u32 drawCount = 0;
+            u64 triangleCount = 0;
+            u64 trianglesSavedByLod = 0;
+            u32 dispatchCount = 0;
+            u32 pipelineBinds = 0;
+            u32 indexBufferBinds = 0;
+            u32 pushConstantUpdates = 0;
+        } stats = {};
 
         struct {
             VkFence fence = nullptr;
@@ -1,2 +1,63 @@
 #include "allocators.hpp"
 
+alloc::Arena alloc::createArena(usize capacity) {
+    return { .memory = (u8*)std::malloc(capacity), .capacity = capacity, .offset = 0 };
+}
+
+void alloc::destroy(Arena* arena) {
+    std::free(arena->memory);
+    *arena = {};
+}
+
+void* alloc::allocate(Arena* arena, usize size, usize alignment) {
+    const usize address = (usize)arena->memory + arena->offset;
+    const usize aligned = (address + alignment - 1) & ~(alignment - 1);
+    const usize end = aligned - (usize)arena->memory + size;
+    if (end > arena->capacity) return nullptr;
+    arena->offset = end;
+    return (void*)aligned;
+}
+
+void alloc::reset(Arena* arena) {
+    arena->offset = 0;
+}
+
+alloc::Pool alloc::createPool(usize blockSize, usize blockCount) {
+    constexpr usize alignment = alignof(std::max_align_t);
+    blockSize = (std::max(blockSize, sizeof(void*)) + alignment - 1) & ~(alignment - 1);
+
+    Pool pool = {
+        .memory = (u8*)std::malloc(blockSize * blockCount),
+        .blockSize = blockSize,
+        .blockCount = blockCount,
+        .freeList = nullptr,
+        .available = blockCount,
+    };
+
+    // link blocks back to front so allocation hands them out in address order
+    for (usize i = blockCount; i > 0; i--) {
+        void* block = pool.memory + (i - 1) * blockSize;
+        *(void**)block = pool.freeList;
+        pool.freeList = block;
+    }
+    return pool;
+}
+
+void alloc::destroy(Pool* pool) {
+    std::free(pool->memory);
+    *pool = {};
+}
+
+void* alloc::allocate(Pool* pool) {
+    void* block = pool->freeList;
+    if (!block) return nullptr;
+    pool->freeList = *(void**)block;
+    pool->available--;
+    return block;
+}
+
+void alloc::deallocate(Pool* pool, void* block) {
+    *(void**)block = pool->freeList;
+    pool->freeList = block;
+    pool->available++;
+}
@@ -3,4 +3,38 @@
 
 namespace flux::alloc {
 
-}
\ No newline at end of file
+    // bump allocator over a single block, everything is freed at once with reset
+    struct Arena {
+        u8* memory = nullptr;
+        usize capacity = 0;
+        usize offset = 0;
+    };
+
+    Arena createArena(usize capacity);
+    void destroy(Arena* arena);
+    // returns nullptr when the arena is full, alignment must be a power of two
+    void* allocate(Arena* arena, usize size, usize alignment = alignof(std::max_align_t));
+    void reset(Arena* arena);
+
+    template <typename T>
+    T* allocate(Arena* arena, usize count = 1) {
+        return (T*)allocate(arena, sizeof(T) * count, alignof(T));
+    }
+
+    // fixed size blocks threaded on an intrusive free list
+    struct Pool {
+        u8* memory = nullptr;
+        usize blockSize = 0;
+        usize blockCount = 0;
+        void* freeList = nullptr;
+        usize available = 0;
+    };
+
+    // blockSize is rounded up to hold a pointer and keep max_align_t alignment
+    Pool createPool(usize blockSize, usize blockCount);
+    void destroy(Pool* pool);
+    // returns nullptr when every block is in use
+    void* allocate(Pool* pool);
+    void deallocate(Pool* pool, void* block);
+
+}
@@ -0,0 +1,147 @@
+#include "bench.hpp"
+#include "log.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace flux::bench {
+    static u64 timeNs(const std::function<void(u64)>& fn, u64 iterations) {
+        const auto start = std::chrono::steady_clock::now();
+        fn(iterations);
+        return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // nearest rank on sorted samples
+    static f64 percentile(const std::vector<f64>& sorted, f64 p) {
+        const usize rank = (usize)std::ceil(p * (f64)sorted.size());
+        return sorted[std::clamp(rank, (usize)1, sorted.size()) - 1];
+    }
+
+    static bool readString(const std::string& line, const char* key, std::string* out) {
+        const auto pattern = std::format("\"{}\":\"", key);
+        const usize begin = line.find(pattern);
+        if (begin == std::string::npos) return false;
+        const usize end = line.find('"', begin + pattern.size());
+        if (end == std::string::npos) return false;
+        *out = line.substr(begin + pattern.size(), end - begin - pattern.size());
+        return true;
+    }
+
+    static bool readNumber(const std::string& line, const char* key, f64* out) {
+        const auto pattern = std::format("\"{}\":", key);
+        const usize begin = line.find(pattern);
+        if (begin == std::string::npos) return false;
+        *out = std::strtod(line.c_str() + begin + pattern.size(), nullptr);
+        return true;
+    }
+}
+
+bench::Result bench::run(const std::string& name, const std::function<void(u64 iterations)>& fn, const Options& options) {
+    // double the iteration count until one repetition is long enough to time reliably
+    u64 iterations = options.iterations;
+    if (iterations == 0) {
+        iterations = 1;
+        while (timeNs(fn, iterations) < config::bench::MIN_REPETITION_NS && iterations < (1ull << 40))
+            iterations *= 2;
+    }
+
+    for (u32 i = 0; i < options.warmup; i++)
+        timeNs(fn, iterations);
+
+    std::vector<f64> samples(options.repetitions);
+    for (auto& sample : samples)
+        sample = (f64)timeNs(fn, iterations) / (f64)iterations;
+    return summarize(name, std::move(samples), "ns", iterations);
+}
+
+bench::Result bench::summarize(const std::string& name, std::vector<f64> samples, const std::string& unit, u64 iterations) {
+    Result result = { .name = name, .unit = unit, .samples = (u32)samples.size(), .iterations = iterations };
+    if (samples.empty()) return result;
+
+    std::sort(samples.begin(), samples.end());
+    f64 sum = 0.0;
+    for (f64 sample : samples) sum += sample;
+    result.mean = sum / (f64)samples.size();
+    f64 variance = 0.0;
+    for (f64 sample : samples) variance += (sample - result.mean) * (sample - result.mean);
+    result.stddev = std::sqrt(variance / (f64)samples.size());
+
+    result.min = samples.front();
+    result.max = samples.back();
+    result.median = (samples.size() % 2 == 1)
+        ? samples[samples.size() / 2]
+        : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) * .5;
+    result.p90 = percentile(samples, .90);
+    result.p99 = percentile(samples, .99);
+    return result;
+}
+
+void bench::print(const Result& result) {
+    log::unbuffered(std::format("{:<40} median {:>12.3f} {}  p90 {:>12.3f}  p99 {:>12.3f}  min {:>12.3f}  ({} x {})",
+        result.name, result.median, result.unit, result.p90, result.p99, result.min, result.samples, result.iterations));
+}
+
+bool bench::writeJson(const std::filesystem::path& path, std::span<const Result> results) {
+    if (path.has_parent_path()) {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+    }
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) return false;
+
+    file << "{\"results\":[\n";
+    for (usize i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        file << std::format("{{\"name\":\"{}\",\"unit\":\"{}\",\"samples\":{},\"iterations\":{},\"min\":{},\"median\":{},"
+            "\"mean\":{},\"p90\":{},\"p99\":{},\"max\":{},\"stddev\":{}}}{}\n",
+            r.name, r.unit, r.samples, r.iterations, r.min, r.median, r.mean, r.p90, r.p99, r.max, r.stddev,
+            (i + 1 < results.size()) ? "," : "");
+    }
+    file << "]}\n";
+    return file.good();
+}
+
+// only reads files written by writeJson, which puts every result on its own line
+std::optional<std::vector<bench::Result>> bench::readJson(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return {};
+
+    std::vector<Result> results;
+    std::string line;
+    while (std::getline(file, line)) {
+        Result result;
+        f64 samples = 0.0, iterations = 0.0;
+        if (!readString(line, "name", &result.name)) continue;
+        readString(line, "unit", &result.unit);
+        readNumber(line, "samples", &samples);
+        readNumber(line, "iterations", &iterations);
+        readNumber(line, "min", &result.min);
+        readNumber(line, "median", &result.median);
+        readNumber(line, "mean", &result.mean);
+        readNumber(line, "p90", &result.p90);
+        readNumber(line, "p99", &result.p99);
+        readNumber(line, "max", &result.max);
+        readNumber(line, "stddev", &result.stddev);
+        result.samples = (u32)samples;
+        result.iterations = (u64)iterations;
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+u32 bench::compare(std::span<const Result> current, std::span<const Result> baseline, f64 tolerance) {
+    u32 regressions = 0;
+    for (const Result& result : current) {
+        const auto base = std::find_if(baseline.begin(), baseline.end(), [&](const Result& r) { return r.name == result.name; });
+        if (base == baseline.end() || base->median <= 0.0) continue;
+
+        const f64 change = result.median / base->median - 1.0;
+        if (change > tolerance) {
+            log::warn(std::format("{}: median {:.3f} -> {:.3f} {} (+{:.1f}%)", result.name, base->median, result.median, result.unit, change * 100.0));
+            regressions++;
+        } else {
+            log::debug(std::format("{}: {:+.1f}%", result.name, change * 100.0));
+        }
+    }
+    return regressions;
+}
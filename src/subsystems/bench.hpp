@@ -0,0 +1,51 @@
+#pragma once
+#include <common.hpp>
+#include <config.hpp>
+
+// benchmark harness shared by flux-bench and headless scene runs. every repetition is timed on its
+// own and the per iteration samples are reduced to order statistics, which are more stable across
+// runs than the mean. results are stored as json, one result object per line, so runs from
+// different commits can be compared with compare()
+namespace flux::bench {
+
+    struct Options {
+        u32 warmup = config::bench::WARMUP_REPETITIONS;
+        u32 repetitions = config::bench::REPETITIONS;
+        u64 iterations = 0;     // per repetition, 0 calibrates to MIN_REPETITION_NS
+    };
+
+    struct Result {
+        std::string name;
+        std::string unit;       // of the statistics below
+        u32 samples = 0;
+        u64 iterations = 0;     // per sample
+        f64 min = 0.0;
+        f64 median = 0.0;
+        f64 mean = 0.0;
+        f64 p90 = 0.0;
+        f64 p99 = 0.0;
+        f64 max = 0.0;
+        f64 stddev = 0.0;
+    };
+
+    // keeps the compiler from discarding a value or the work that produced it
+    template <typename T>
+    void doNotOptimize(T const& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // runs fn(iterations) once per repetition and reports ns per iteration
+    Result run(const std::string& name, const std::function<void(u64 iterations)>& fn, const Options& options = {});
+
+    // reduces raw samples, e.g. frame times, to a result
+    Result summarize(const std::string& name, std::vector<f64> samples, const std::string& unit, u64 iterations = 1);
+
+    void print(const Result& result);
+    bool writeJson(const std::filesystem::path& path, std::span<const Result> results);
+    std::optional<std::vector<Result>> readJson(const std::filesystem::path& path);
+
+    // logs every result whose median is more than tolerance (relative) slower than in baseline,
+    // returns the number of regressions
+    u32 compare(std::span<const Result> current, std::span<const Result> baseline, f64 tolerance);
+
+}
@@ -0,0 +1,100 @@
+#include "jobs.hpp"
+#include "profiler.hpp"
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+namespace flux::jobs {
+    struct QueuedJob {
+        Counter* counter = nullptr;
+        Job job = {};
+    };
+
+    static std::vector<std::thread> workers;
+    static std::deque<QueuedJob> queue;
+    static std::mutex queueMutex;
+    static std::condition_variable queueCondition;
+    static bool running = false;
+
+    static bool tryPop(QueuedJob* out) {
+        std::lock_guard lock(queueMutex);
+        if (queue.empty()) return false;
+        *out = std::move(queue.front());
+        queue.pop_front();
+        return true;
+    }
+
+    static void execute(QueuedJob& queued) {
+        PROFILE_ZONE("job");
+        queued.job();
+        queued.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    static void workerLoop(u32 index) {
+        PROFILE_THREAD(std::format("worker {}", index).c_str());
+        while (true) {
+            QueuedJob queued;
+            {
+                std::unique_lock lock(queueMutex);
+                queueCondition.wait(lock, [] { return !queue.empty() || !running; });
+                if (queue.empty()) return; // only reached once stopped and drained
+                queued = std::move(queue.front());
+                queue.pop_front();
+            }
+            execute(queued);
+        }
+    }
+}
+
+void jobs::init(u32 count) {
+    if (count == 0) count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    running = true;
+    workers.reserve(count);
+    for (u32 i = 0; i < count; i++)
+        workers.emplace_back(workerLoop, i);
+}
+
+void jobs::deinit() {
+    {
+        std::lock_guard lock(queueMutex);
+        running = false;
+    }
+    queueCondition.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+    workers.clear();
+}
+
+u32 jobs::workerCount() {
+    return (u32)workers.size();
+}
+
+void jobs::run(Counter* counter, Job&& job) {
+    counter->pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard lock(queueMutex);
+        queue.push_back({ counter, std::move(job) });
+    }
+    queueCondition.notify_one();
+}
+
+void jobs::parallelFor(u32 count, u32 batchSize, const std::function<void(u32 begin, u32 end)>& fn) {
+    batchSize = std::max(batchSize, 1u);
+    Counter counter;
+    for (u32 begin = 0; begin < count;) {
+        const u32 end = begin + std::min(batchSize, count - begin);
+        run(&counter, [&fn, begin, end] { fn(begin, end); });
+        begin = end;
+    }
+    wait(&counter);
+}
+
+void jobs::wait(Counter* counter) {
+    PROFILE_ZONE("jobs wait");
+    while (counter->pending.load(std::memory_order_acquire) > 0) {
+        QueuedJob queued;
+        if (tryPop(&queued)) execute(queued);
+        else std::this_thread::yield();
+    }
+}
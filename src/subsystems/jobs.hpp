@@ -0,0 +1,26 @@
+#pragma once
+#include <common.hpp>
+
+namespace flux::jobs {
+
+    // tracks completion of a group of jobs, wait on it with jobs::wait
+    struct Counter {
+        std::atomic<u32> pending = 0;
+    };
+
+    using Job = std::function<void()>;
+
+    // workerCount of 0 uses hardware concurrency - 1 (calling thread also executes jobs while waiting)
+    void init(u32 workerCount = 0);
+    void deinit();
+    u32 workerCount();
+
+    void run(Counter* counter, Job&& job);
+
+    // splits [0, count) into batches of batchSize and runs fn(begin, end) on each, blocks until done
+    void parallelFor(u32 count, u32 batchSize, const std::function<void(u32 begin, u32 end)>& fn);
+
+    // executes queued jobs on the calling thread until counter reaches zero
+    void wait(Counter* counter);
+
+}
@@ -1,8 +1,12 @@
 #include "log.hpp"
 
+#include <mutex>
+
 namespace flux::log {
     static char buffer[config::log::BUFFER_SIZE] = {0};
     static usize index = 0;
+    static std::mutex bufferMutex;  // guards buffer and index, buffered() may be called from any thread
+    static FILE* outputFile = config::log::OUTPUT_FILE;
     static const char* levelStrings[] = {
         "DEBUG",
         "WARNING",
@@ -10,24 +14,52 @@ namespace flux::log {
         "VULKAN",
         "TODO",
     };
+
+    // "[LEVEL] msg\n" without a null terminator
+    static usize writeEntry(char* dst, const std::string& msg, level lvl) {
+        const usize levelLength = strlen(levelStrings[(usize)lvl]);
+        dst[0] = '[';
+        memcpy(dst + 1, levelStrings[(usize)lvl], levelLength);
+        memcpy(dst + 1 + levelLength, "] ", 2);
+        memcpy(dst + 3 + levelLength, msg.data(), msg.size());
+        dst[3 + levelLength + msg.size()] = '\n';
+        return levelLength + msg.size() + 4;
+    }
+
+    static void flushLocked() {
+        fwrite(buffer, 1, index, outputFile);
+        index = 0;
+    }
 }
 
 void log::buffered(const std::string& msg, level lvl) {
-    sprintf(buffer + index, "[%s] %s\n", levelStrings[(usize)lvl], msg.c_str());
-    index += strlen(buffer + index);
+    const usize length = strlen(levelStrings[(usize)lvl]) + msg.size() + 4;
+    std::lock_guard lock(bufferMutex);
+    if (index + length > config::log::BUFFER_SIZE)
+        flushLocked();
+    // entries larger than the whole buffer bypass it, order is kept since it was just flushed
+    if (length > config::log::BUFFER_SIZE) {
+        fprintf(outputFile, "[%s] %.*s\n", levelStrings[(usize)lvl], (i32)msg.size(), msg.data());
+        return;
+    }
 
+    index += writeEntry(buffer + index, msg, lvl);
     if (index >= config::log::BUFFER_FLUSH_CAPACITY)
-        flush();
+        flushLocked();
 }
 
 void log::unbuffered(const std::string& msg, level lvl) {
-    fprintf(config::log::OUTPUT_FILE, "[%s] %s\n", levelStrings[(usize)lvl], msg.c_str());
+    fprintf(outputFile, "[%s] %s\n", levelStrings[(usize)lvl], msg.c_str());
 }
 
 void log::flush() {
-    fwrite(buffer, 1, index, config::log::OUTPUT_FILE);
-    memset(buffer, 0, index);
-    index = 0;
+    std::lock_guard lock(bufferMutex);
+    flushLocked();
+}
+
+void log::setOutputFile(FILE* file) {
+    std::lock_guard lock(bufferMutex);
+    outputFile = file;
 }
 
 void log::debug(const std::string& msg) {
@@ -12,9 +12,12 @@ namespace flux::log {
         TODO,
     };
 
+    // thread safe, written out once the buffer reaches config::log::BUFFER_FLUSH_CAPACITY or on flush
     void buffered(const std::string& msg, level lvl = level::DEBUG);
     void unbuffered(const std::string& msg, level lvl = level::DEBUG);
     void flush();
+    // defaults to config::log::OUTPUT_FILE
+    void setOutputFile(FILE* file);
 
     void debug(const std::string& msg);
     void warn(const std::string& msg);
@@ -7,6 +7,7 @@
     #define GLM_FORCE_RADIANS
     #define GLM_FORCE_DEPTH_ZERO_TO_ONE
     #include <glm/glm.hpp>
+    #include <glm/gtc/matrix_transform.hpp>
 #pragma clang diagnostic pop
 
 namespace flux::math {
@@ -0,0 +1,166 @@
+#include "profiler.hpp"
+
+#if FLUX_PROFILER
+
+#include <mutex>
+
+namespace flux::profiler {
+    // fields are atomics so readers racing the writer see stale or new values instead of undefined
+    // behaviour, torn records are then discarded through the written counter (seqlock style). fields
+    // are stored with release and loaded with acquire, which is free on x86 and unlike standalone
+    // fences is understood by tsan
+    struct StoredZone {
+        std::atomic<const char*> name = nullptr;
+        std::atomic<u64> start = 0;
+        std::atomic<u64> end = 0;
+        std::atomic<u32> depth = 0;
+    };
+
+    struct ThreadBuffer {
+        std::string name;
+        u32 index = 0;
+        u32 depth = 0;
+        std::atomic<u64> written = 0;   // total zones ever written, only the owning thread stores
+        std::array<StoredZone, config::profiler::THREAD_BUFFER_SIZE> zones = {};
+    };
+
+    static const auto origin = std::chrono::steady_clock::now();
+
+    // buffers are never freed so zones of exited threads stay readable
+    static std::mutex threadsMutex;
+    static std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    static thread_local ThreadBuffer* localBuffer = nullptr;
+
+    static std::array<std::atomic<u64>, config::profiler::FRAME_HISTORY> frameMarks = {};
+    static std::atomic<u64> frameCount = 0;
+
+    static ThreadBuffer* getLocalBuffer() {
+        if (localBuffer) return localBuffer;
+        std::lock_guard lock(threadsMutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->index = (u32)threads.size();
+        buffer->name = std::format("thread {}", buffer->index);
+        localBuffer = buffer.get();
+        threads.push_back(std::move(buffer));
+        return localBuffer;
+    }
+
+    // copies the zones still present in a buffer, dropping any the writer lapped during the copy.
+    // the writer may be overwriting slot (lapped % size) without having published it yet, so that
+    // record is dropped too
+    static void readBuffer(const ThreadBuffer& buffer, std::vector<ZoneRecord>* out, u64 begin, u64 end) {
+        constexpr u64 size = config::profiler::THREAD_BUFFER_SIZE;
+        const u64 written = buffer.written.load(std::memory_order_acquire);
+        const u64 first = (written > size) ? written - size : 0;
+        std::vector<ZoneRecord> copy(written - first);
+        for (u64 i = first; i < written; i++) {
+            const StoredZone& zone = buffer.zones[i % size];
+            copy[i - first] = {
+                .name = zone.name.load(std::memory_order_acquire),
+                .start = zone.start.load(std::memory_order_acquire),
+                .end = zone.end.load(std::memory_order_acquire),
+                .depth = zone.depth.load(std::memory_order_acquire),
+                .thread = buffer.index,
+            };
+        }
+
+        // a field load that saw the writer's next record synchronises with it, so this load then also
+        // sees the counter store that preceded that record
+        const u64 lapped = buffer.written.load(std::memory_order_acquire);
+        const u64 valid = std::max(first, (lapped + 1 > size) ? lapped + 1 - size : 0);
+        for (u64 i = valid; i < written; i++) {
+            const ZoneRecord& zone = copy[i - first];
+            if (zone.end > begin && zone.start < end) out->push_back(zone);
+        }
+    }
+}
+
+u64 profiler::now() {
+    return (u64)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+profiler::Zone::Zone(const char* zoneName) : name(zoneName), start(now()) {
+    getLocalBuffer()->depth++;
+}
+
+profiler::Zone::~Zone() {
+    ThreadBuffer* buffer = getLocalBuffer();
+    buffer->depth--;
+    const u64 index = buffer->written.load(std::memory_order_relaxed);
+    StoredZone& zone = buffer->zones[index % config::profiler::THREAD_BUFFER_SIZE];
+    zone.name.store(name, std::memory_order_release);
+    zone.start.store(start, std::memory_order_release);
+    zone.end.store(now(), std::memory_order_release);
+    zone.depth.store(buffer->depth, std::memory_order_release);
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void profiler::setThreadName(const char* name) {
+    ThreadBuffer* buffer = getLocalBuffer();
+    std::lock_guard lock(threadsMutex);
+    buffer->name = name;
+}
+
+void profiler::frameMark() {
+    const u64 count = frameCount.load(std::memory_order_relaxed);
+    frameMarks[count % config::profiler::FRAME_HISTORY].store(now(), std::memory_order_relaxed);
+    frameCount.store(count + 1, std::memory_order_release);
+}
+
+std::pair<u64, u64> profiler::lastFrame() {
+    const u64 count = frameCount.load(std::memory_order_acquire);
+    if (count < 2) return { 0, 0 };
+    return {
+        frameMarks[(count - 2) % config::profiler::FRAME_HISTORY].load(std::memory_order_relaxed),
+        frameMarks[(count - 1) % config::profiler::FRAME_HISTORY].load(std::memory_order_relaxed),
+    };
+}
+
+std::vector<profiler::ZoneRecord> profiler::zones(u64 begin, u64 end) {
+    std::vector<ZoneRecord> result;
+    std::lock_guard lock(threadsMutex);
+    for (const auto& buffer : threads)
+        readBuffer(*buffer, &result, begin, end);
+    return result;
+}
+
+std::vector<std::string> profiler::threadNames() {
+    std::lock_guard lock(threadsMutex);
+    std::vector<std::string> result;
+    result.reserve(threads.size());
+    for (const auto& buffer : threads)
+        result.push_back(buffer->name);
+    return result;
+}
+
+bool profiler::exportChromeTrace(const std::filesystem::path& path) {
+    const auto recorded = zones(0, std::numeric_limits<u64>::max());
+    const auto names = threadNames();
+
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+
+    // complete ("X") events in microseconds, plus thread name metadata
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (usize i = 0; i < names.size(); i++)
+        file << std::format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}},\n", i, names[i]);
+    for (const auto& zone : recorded)
+        file << std::format("{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}},\n",
+            zone.name, zone.thread, (f64)zone.start * 1e-3, (f64)(zone.end - zone.start) * 1e-3);
+    file << "{}]}\n";
+    return file.good();
+}
+
+#else
+
+u64 profiler::now() { return 0; }
+profiler::Zone::Zone(const char* zoneName) : name(zoneName), start(0) {}
+profiler::Zone::~Zone() {}
+void profiler::setThreadName(const char*) {}
+void profiler::frameMark() {}
+std::pair<u64, u64> profiler::lastFrame() { return { 0, 0 }; }
+std::vector<profiler::ZoneRecord> profiler::zones(u64, u64) { return {}; }
+std::vector<std::string> profiler::threadNames() { return {}; }
+bool profiler::exportChromeTrace(const std::filesystem::path&) { return false; }
+
+#endif
@@ -0,0 +1,59 @@
+#pragma once
+#include <common.hpp>
+#include <config.hpp>
+
+// scoped cpu zones. every thread records into its own ring buffer (single writer, published with a
+// release store), so recording never takes a lock. readers copy the most recent zones out of all
+// buffers for the ui timeline or a chrome trace (chrome://tracing, ui.perfetto.dev)
+namespace flux::profiler {
+
+    // ns since profiler start
+    u64 now();
+
+    struct ZoneRecord {
+        const char* name;   // must outlive the profiler, string literals are expected
+        u64 start;
+        u64 end;
+        u32 depth;
+        u32 thread;         // index into threadNames()
+    };
+
+    // scope guard, use through PROFILE_ZONE so it compiles out when disabled
+    struct Zone {
+        const char* name;
+        u64 start;
+        explicit Zone(const char* name);
+        ~Zone();
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+    };
+
+    // names the calling thread in timelines and traces
+    void setThreadName(const char* name);
+
+    // marks the start of a frame, called once per frame from the main thread
+    void frameMark();
+
+    // start and end of the most recent completed frame, {0, 0} before the second mark
+    std::pair<u64, u64> lastFrame();
+
+    // zones of all threads overlapping [begin, end), zones overwritten while reading are skipped
+    std::vector<ZoneRecord> zones(u64 begin, u64 end);
+    std::vector<std::string> threadNames();
+
+    // writes every buffered zone as chrome trace event json
+    bool exportChromeTrace(const std::filesystem::path& path);
+
+}
+
+#if FLUX_PROFILER
+    #define FLUX_PROFILE_CONCAT_INNER(a, b) a##b
+    #define FLUX_PROFILE_CONCAT(a, b) FLUX_PROFILE_CONCAT_INNER(a, b)
+    #define PROFILE_ZONE(name) const flux::profiler::Zone FLUX_PROFILE_CONCAT(profileZone, __COUNTER__)(name)
+    #define PROFILE_FRAME() flux::profiler::frameMark()
+    #define PROFILE_THREAD(name) flux::profiler::setThreadName(name)
+#else
+    #define PROFILE_ZONE(name) ((void)0)
+    #define PROFILE_FRAME() ((void)0)
+    #define PROFILE_THREAD(name) ((void)0)
+#endif
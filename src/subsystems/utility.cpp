@@ -3,6 +3,8 @@
 #include <core/engine.hpp>
 #include <subsystems/log.hpp>
 
+#include <cmath>
+
 void utility::flushDeinitStack(DeinitStack* deinitStack) {
     while (!deinitStack->empty()) {
         deinitStack->back()();
@@ -11,8 +13,9 @@ void utility::flushDeinitStack(DeinitStack* deinitStack) {
 }
 
 std::pair<u32, u32> utility::getWindowSize(const EngineState* state) {
+    if (!state->window) return { state->options.width, state->options.height };
     i32 w, h;
-    glfwGetWindowSize(state->window, &w, &h);
+    glfwGetFramebufferSize(state->window, &w, &h);
     return { (u32)w, (u32)h };
 }
 
@@ -21,8 +24,34 @@ std::pair<u32, u32> utility::getMonitorRes(const EngineState* state) {
     return { (u32)mode->width, (u32)mode->height };
 }
 
-void utility::sleepMs(const u32 ms) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+void utility::sleepUntil(std::chrono::steady_clock::time_point deadline) {
+    using clock = std::chrono::steady_clock;
+    // exponentially weighted mean and variance of how long a 1ms sleep actually takes
+    constexpr f64 WEIGHT = 0.05;
+    thread_local f64 mean = 2e-3, variance = 0.0;
+
+    while (std::chrono::duration<f64>(deadline - clock::now()).count() > mean + 2.0 * std::sqrt(variance)) {
+        const auto start = clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        const f64 observed = std::chrono::duration<f64>(clock::now() - start).count();
+
+        const f64 delta = observed - mean;
+        mean += WEIGHT * delta;
+        variance = (1.0 - WEIGHT) * (variance + WEIGHT * delta * delta);
+    }
+
+    while (clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+std::optional<std::vector<u8>> utility::readFile(const std::filesystem::path& filePath) {
+    std::ifstream file(filePath, std::ios::ate | std::ios::binary);
+    if (!file.is_open()) return {};
+    std::vector<u8> bytes((usize)file.tellg());
+    file.seekg(0);
+    file.read((char*)bytes.data(), (i64)bytes.size());
+    if (!file.good()) return {};
+    return bytes;
 }
 
 void utility::abort() {
@@ -3,9 +3,13 @@
 
 namespace flux::utility {
     void flushDeinitStack(DeinitStack* deinitStack);
+    // in pixels, 0x0 while minimised
     std::pair<u32, u32> getWindowSize(const EngineState* state);
     std::pair<u32, u32> getMonitorRes(const EngineState* state);
-    void sleepMs(u32 ms);
+    // sleeps in short steps while the remaining time exceeds the expected oversleep, then spins.
+    // accurate to well below a millisecond, unlike a single sleep_for
+    void sleepUntil(std::chrono::steady_clock::time_point deadline);
+    std::optional<std::vector<u8>> readFile(const std::filesystem::path& filePath);
 
     [[noreturn]] void abort();
     [[noreturn]] void exitWithFailure();
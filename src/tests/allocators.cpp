@@ -0,0 +1,89 @@
+#include "test.hpp"
+#include <subsystems/allocators.hpp>
+
+#include <algorithm>
+#include <set>
+
+TEST(allocators, arena_alignment_and_capacity) {
+    auto arena = alloc::createArena(256);
+    void* a = alloc::allocate(&arena, 1, 1);
+    void* b = alloc::allocate(&arena, 8, 64);
+    CHECK(a != nullptr && b != nullptr);
+    CHECK((usize)b % 64 == 0);
+    CHECK((u8*)b > (u8*)a);
+    CHECK(alloc::allocate(&arena, 512) == nullptr);
+    CHECK(alloc::allocate<u32>(&arena, 4) != nullptr);
+
+    // a failed allocation must not consume space
+    const usize offset = arena.offset;
+    CHECK(alloc::allocate(&arena, 1024) == nullptr);
+    CHECK(arena.offset == offset);
+
+    alloc::reset(&arena);
+    CHECK(arena.offset == 0);
+    CHECK(alloc::allocate(&arena, 256, 1) == arena.memory);
+    CHECK(alloc::allocate(&arena, 1, 1) == nullptr);
+    alloc::destroy(&arena);
+    CHECK(arena.memory == nullptr && arena.capacity == 0);
+}
+
+TEST(allocators, pool_exhaustion_and_reuse) {
+    constexpr usize COUNT = 64;
+    auto pool = alloc::createPool(3, COUNT);
+    CHECK(pool.blockSize >= sizeof(void*));
+    CHECK(pool.blockSize % alignof(std::max_align_t) == 0);
+
+    std::set<void*> blocks;
+    for (usize i = 0; i < COUNT; i++) {
+        void* block = alloc::allocate(&pool);
+        CHECK(block != nullptr);
+        CHECK((usize)block % alignof(std::max_align_t) == 0);
+        CHECK((u8*)block >= pool.memory && (u8*)block < pool.memory + pool.blockSize * COUNT);
+        blocks.insert(block);
+    }
+    CHECK(blocks.size() == COUNT);
+    CHECK(pool.available == 0);
+    CHECK(alloc::allocate(&pool) == nullptr);
+
+    // the most recently freed block is handed out first
+    void* freed = *blocks.begin();
+    alloc::deallocate(&pool, freed);
+    CHECK(pool.available == 1);
+    CHECK(alloc::allocate(&pool) == freed);
+    alloc::destroy(&pool);
+}
+
+// allocators are single threaded, the supported pattern is one instance per thread. each thread fills
+// its blocks with its own pattern and verifies them, so overlapping blocks show up as corruption
+TEST(allocators, stress_per_thread_instances) {
+    test::stress([](u32 thread) {
+        auto arena = alloc::createArena(64 * 1024);
+        auto pool = alloc::createPool(48, 256);
+        std::vector<u8*> live;
+        for (u32 i = 0; i < config::test::STRESS_ITERATIONS; i++) {
+            const u8 pattern = (u8)(thread * 31 + i);
+            if (u8* block = (u8*)alloc::allocate(&pool)) {
+                std::memset(block, pattern, 48);
+                live.push_back(block);
+            }
+            if (live.size() == 256 || (i % 7 == 0 && !live.empty())) {
+                u8* block = live.back();
+                live.pop_back();
+                CHECK(std::all_of(block + 1, block + 48, [&](u8 b) { return b == block[0]; }));
+                alloc::deallocate(&pool, block);
+            }
+
+            const usize size = 1 + i % 200;
+            u8* memory = (u8*)alloc::allocate(&arena, size, 16);
+            if (!memory) {
+                alloc::reset(&arena);
+                memory = (u8*)alloc::allocate(&arena, size, 16);
+            }
+            CHECK(memory != nullptr && (usize)memory % 16 == 0);
+            if (memory) std::memset(memory, pattern, size);
+        }
+        CHECK(pool.available + live.size() == 256);
+        alloc::destroy(&pool);
+        alloc::destroy(&arena);
+    });
+}
@@ -0,0 +1,80 @@
+#include "test.hpp"
+#include <subsystems/jobs.hpp>
+
+#include <algorithm>
+
+// every test starts and stops its own job system, which also covers repeated init/deinit
+
+TEST(jobs, run_and_wait) {
+    jobs::init(4);
+    CHECK(jobs::workerCount() == 4);
+    jobs::Counter counter;
+    std::atomic<u32> sum = 0;
+    for (u32 i = 1; i <= 1000; i++)
+        jobs::run(&counter, [&sum, i] { sum.fetch_add(i, std::memory_order_relaxed); });
+    jobs::wait(&counter);
+    CHECK(counter.pending.load() == 0);
+    CHECK(sum.load() == 1000 * 1001 / 2);
+    jobs::deinit();
+}
+
+// waiting with no workers must still finish by running jobs on the calling thread
+TEST(jobs, wait_without_workers) {
+    jobs::init(0);
+    jobs::deinit();
+    jobs::Counter counter;
+    u32 ran = 0;
+    for (u32 i = 0; i < 16; i++)
+        jobs::run(&counter, [&ran] { ran++; });
+    jobs::wait(&counter);
+    CHECK(ran == 16);
+}
+
+TEST(jobs, parallel_for_covers_every_index_once) {
+    jobs::init(4);
+    for (u32 batch : { 1u, 7u, 64u, 5000u }) {
+        std::vector<std::atomic<u32>> hits(4099);
+        jobs::parallelFor((u32)hits.size(), batch, [&](u32 begin, u32 end) {
+            CHECK(begin < end && end - begin <= batch);
+            for (u32 i = begin; i < end; i++)
+                hits[i].fetch_add(1, std::memory_order_relaxed);
+        });
+        CHECK(std::all_of(hits.begin(), hits.end(), [](const auto& hit) { return hit.load() == 1; }));
+    }
+    jobs::parallelFor(0, 16, [](u32, u32) { CHECK(false); });
+    jobs::deinit();
+}
+
+// jobs that spawn and wait on their own jobs, waiting runs queued jobs so this cannot deadlock
+TEST(jobs, nested_wait) {
+    jobs::init(2);
+    std::atomic<u32> leaves = 0;
+    jobs::Counter outer;
+    for (u32 i = 0; i < 32; i++) {
+        jobs::run(&outer, [&leaves] {
+            jobs::Counter inner;
+            for (u32 j = 0; j < 32; j++)
+                jobs::run(&inner, [&leaves] { leaves.fetch_add(1, std::memory_order_relaxed); });
+            jobs::wait(&inner);
+        });
+    }
+    jobs::wait(&outer);
+    CHECK(leaves.load() == 32 * 32);
+    jobs::deinit();
+}
+
+// many producer threads submit into the shared queue and wait on their own counters, results
+// written by jobs must be visible after wait returns
+TEST(jobs, stress_concurrent_producers) {
+    jobs::init(4);
+    test::stress([](u32 thread) {
+        std::vector<u32> results(config::test::STRESS_ITERATIONS / 16);
+        jobs::Counter counter;
+        for (u32 i = 0; i < results.size(); i++)
+            jobs::run(&counter, [&results, thread, i] { results[i] = thread ^ i; });
+        jobs::wait(&counter);
+        for (u32 i = 0; i < results.size(); i++)
+            CHECK(results[i] == (thread ^ i));
+    });
+    jobs::deinit();
+}
@@ -0,0 +1,95 @@
+#include "test.hpp"
+#include <subsystems/log.hpp>
+
+// captures everything the logger writes while in scope
+namespace {
+    struct Capture {
+        FILE* file = std::tmpfile();
+        Capture() { log::setOutputFile(file); }
+        ~Capture() {
+            log::setOutputFile(config::log::OUTPUT_FILE);
+            std::fclose(file);
+        }
+
+        std::string read() {
+            log::flush();
+            std::fflush(file);
+            std::string result;
+            std::rewind(file);
+            char chunk[4096];
+            usize count;
+            while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+                result.append(chunk, count);
+            return result;
+        }
+    };
+}
+
+TEST(log, buffered_is_held_until_flush) {
+    Capture capture;
+    log::buffered("first");
+    log::buffered("second", log::level::WARNING);
+    std::fflush(capture.file);
+    CHECK(std::ftell(capture.file) == 0);
+    CHECK(capture.read() == "[DEBUG] first\n[WARNING] second\n");
+}
+
+TEST(log, flushes_at_capacity) {
+    Capture capture;
+    const std::string message(1024, 'x');
+    const usize entry = message.size() + std::strlen("[DEBUG] \n");
+    const usize count = config::log::BUFFER_FLUSH_CAPACITY / entry + 1;
+    for (usize i = 0; i < count; i++)
+        log::buffered(message);
+    std::fflush(capture.file);
+    CHECK((usize)std::ftell(capture.file) >= config::log::BUFFER_FLUSH_CAPACITY);
+    CHECK(capture.read().size() == entry * count);
+}
+
+TEST(log, oversized_entries_bypass_the_buffer) {
+    Capture capture;
+    log::buffered("before");
+    const std::string message(config::log::BUFFER_SIZE, 'y');
+    log::buffered(message);
+    log::buffered("after");
+    const std::string output = capture.read();
+    CHECK(output.size() == std::strlen("[DEBUG] before\n") + message.size() + std::strlen("[DEBUG] \n") + std::strlen("[DEBUG] after\n"));
+    CHECK(output.starts_with("[DEBUG] before\n[DEBUG] yyy"));
+    CHECK(output.ends_with("y\n[DEBUG] after\n"));
+}
+
+TEST(log, embedded_nulls_are_kept) {
+    Capture capture;
+    log::buffered(std::string("a\0b", 3));
+    CHECK(capture.read() == std::string("[DEBUG] a\0b\n", 12));
+}
+
+// every thread logs numbered lines, each line must come out whole and per thread order must hold
+TEST(log, stress_concurrent_buffered) {
+    Capture capture;
+    constexpr u32 LINES = config::test::STRESS_ITERATIONS;
+    test::stress([](u32 thread) {
+        for (u32 i = 0; i < LINES; i++)
+            log::buffered(std::format("{} {} padding to make entries cross flush boundaries", thread, i));
+    });
+
+    const std::string output = capture.read();
+    std::vector<u32> next(config::test::STRESS_THREADS, 0);
+    u32 lines = 0;
+    for (usize begin = 0; begin < output.size();) {
+        const usize end = output.find('\n', begin);
+        CHECK(end != std::string::npos);
+        if (end == std::string::npos) break;
+        u32 thread = 0, index = 0;
+        const std::string line = output.substr(begin, end - begin);
+        const i32 parsed = std::sscanf(line.c_str(), "[DEBUG] %u %u padding", &thread, &index);
+        CHECK(parsed == 2 && thread < next.size());
+        if (parsed == 2 && thread < next.size()) {
+            CHECK(index == next[thread]);
+            next[thread] = index + 1;
+        }
+        lines++;
+        begin = end + 1;
+    }
+    CHECK(lines == LINES * config::test::STRESS_THREADS);
+}
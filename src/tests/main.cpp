@@ -0,0 +1,59 @@
+#include "test.hpp"
+#include <subsystems/log.hpp>
+
+#include <mutex>
+
+namespace flux::test {
+    static std::atomic<u32> failures = 0;
+    static std::mutex failMutex;
+}
+
+std::vector<test::Case>& test::registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+test::Register::Register(const char* suite, const char* name, Fn fn) {
+    registry().push_back({ suite, name, fn });
+}
+
+void test::fail(const char* expression, const char* file, i32 line) {
+    failures.fetch_add(1, std::memory_order_relaxed);
+    std::lock_guard lock(failMutex);
+    log::error(std::format("{}:{}: CHECK({}) failed", file, line, expression));
+}
+
+u32 test::takeFailures() {
+    return failures.exchange(0, std::memory_order_relaxed);
+}
+
+void test::stress(const std::function<void(u32 thread)>& fn) {
+    std::vector<std::thread> threads;
+    threads.reserve(config::test::STRESS_THREADS);
+    for (u32 i = 0; i < config::test::STRESS_THREADS; i++)
+        threads.emplace_back(fn, i);
+    for (auto& thread : threads)
+        thread.join();
+}
+
+// flux-test [filter], runs every test whose "suite/name" contains filter
+i32 main(i32 argc, char** argv) {
+    const std::string_view filter = (argc > 1) ? argv[1] : "";
+    u32 run = 0, failed = 0;
+    for (const auto& test : test::registry()) {
+        const auto name = std::format("{}/{}", test.suite, test.name);
+        if (name.find(filter) == std::string::npos) continue;
+
+        const auto start = std::chrono::steady_clock::now();
+        test.fn();
+        const f64 ms = std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const u32 failures = test::takeFailures();
+        run++;
+        if (failures > 0) failed++;
+        log::unbuffered(std::format("{} {} ({:.1f} ms)", failures > 0 ? "FAIL" : "ok  ", name, ms),
+            failures > 0 ? log::level::ERROR : log::level::DEBUG);
+    }
+
+    log::unbuffered(std::format("{} of {} tests passed", run - failed, run), failed > 0 ? log::level::ERROR : log::level::DEBUG);
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
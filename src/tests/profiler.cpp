@@ -0,0 +1,59 @@
+#include "test.hpp"
+#include <subsystems/profiler.hpp>
+
+#include <algorithm>
+
+#if FLUX_PROFILER
+
+TEST(profiler, nested_zones) {
+    const u64 begin = profiler::now();
+    {
+        PROFILE_ZONE("test outer");
+        PROFILE_ZONE("test inner");
+    }
+    const auto recorded = profiler::zones(begin, profiler::now() + 1);
+    const profiler::ZoneRecord* outer = nullptr;
+    const profiler::ZoneRecord* inner = nullptr;
+    for (const auto& zone : recorded) {
+        if (std::string_view(zone.name) == "test outer") outer = &zone;
+        if (std::string_view(zone.name) == "test inner") inner = &zone;
+    }
+    CHECK(outer != nullptr && inner != nullptr);
+    if (outer && inner) {
+        CHECK(inner->depth == outer->depth + 1);
+        CHECK(outer->start <= inner->start && inner->end <= outer->end);
+        CHECK(inner->thread == outer->thread);
+    }
+}
+
+// writers lap their ring buffers many times over while a reader keeps copying them. every zone read
+// must be one that was actually written, never a mix of two records
+TEST(profiler, stress_readers_racing_writers) {
+    static constexpr const char* NAMES[] = { "stress a", "stress b", "stress c" };
+    std::atomic<bool> done = false;
+    std::atomic<u32> reads = 0;
+    std::thread reader([&] {
+        while (!done.load(std::memory_order_acquire) || reads.load() == 0) {
+            for (const auto& zone : profiler::zones(0, std::numeric_limits<u64>::max())) {
+                if (zone.name != NAMES[0] && zone.name != NAMES[1] && zone.name != NAMES[2]) continue;
+                CHECK(zone.start <= zone.end);
+                // each name is only ever recorded at one depth
+                CHECK(zone.depth == (u32)(std::find(std::begin(NAMES), std::end(NAMES), zone.name) - std::begin(NAMES)));
+            }
+            reads.fetch_add(1);
+        }
+    });
+
+    test::stress([](u32) {
+        for (u32 i = 0; i < config::test::STRESS_ITERATIONS * 4; i++) {
+            PROFILE_ZONE(NAMES[0]);
+            PROFILE_ZONE(NAMES[1]);
+            PROFILE_ZONE(NAMES[2]);
+        }
+    });
+    done.store(true, std::memory_order_release);
+    reader.join();
+    CHECK(reads.load() > 0);
+}
+
+#endif
@@ -0,0 +1,23 @@
+// the renderer internals are header only with non inline definitions and expect the vma implementation
+// in the including tu, so every renderer suite in tests/renderer is compiled as part of this one tu
+#define VMA_IMPLEMENTATION
+#include "test.hpp"
+#include <renderer/renderer.hpp>
+
+#include <algorithm>
+
+using namespace flux::renderer;
+
+// bookkeeping only, no device is created
+namespace {
+    std::unique_ptr<RendererState> createState() {
+        return std::make_unique<RendererState>(RendererState{ .engine = nullptr });
+    }
+}
+
+#include "renderer/descriptors.cpp"
+#include "renderer/deletion.cpp"
+#include "renderer/reflection.cpp"
+#include "renderer/instances.cpp"
+#include "renderer/materials.cpp"
+#include "renderer/draws.cpp"
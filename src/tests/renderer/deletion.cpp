@@ -0,0 +1,20 @@
+#include <renderer/internal/deletion.hpp>
+
+// records only become ready once the frame that retired them has completed, and always as a prefix
+TEST(deletion, ready_waits_for_frames_in_flight) {
+    auto state = createState();
+    deletion::retireImageView(state.get(), VK_NULL_HANDLE);
+    deletion::retireSampler(state.get(), VK_NULL_HANDLE);
+    state->frameNumber++;
+    deletion::retirePipeline(state.get(), VK_NULL_HANDLE);
+    CHECK(state->deletionQueue.size() == 3);
+
+    CHECK(deletion::ready(state.get()) == 0);
+    state->frameNumber = config::renderer::FRAME_OVERLAP - 1;
+    CHECK(deletion::ready(state.get()) == 0);
+    state->frameNumber = config::renderer::FRAME_OVERLAP;
+    CHECK(deletion::ready(state.get()) == 2);
+    state->frameNumber = config::renderer::FRAME_OVERLAP + 1;
+    CHECK(deletion::ready(state.get()) == 3);
+    CHECK(state->deletionQueue[2].type == DeletionType::PIPELINE && state->deletionQueue[2].frame == 1);
+}
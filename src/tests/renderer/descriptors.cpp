@@ -0,0 +1,93 @@
+#include <renderer/internal/descriptors.hpp>
+
+#include <set>
+
+// writes queue up in pendingWriteDescriptors since the descriptor buffer backend is disabled on a
+// fresh state
+
+TEST(descriptors, ids_are_unique_and_queue_writes) {
+    auto state = createState();
+    std::set<u32> ids;
+    for (u32 i = 0; i < 100; i++)
+        ids.insert((u32)descriptors::registerStorageImage(state.get(), VK_NULL_HANDLE));
+    CHECK(ids.size() == 100);
+    CHECK(!ids.contains((u32)StorageImageId::INVALID));
+    CHECK(state->pendingWriteDescriptors.size() == 100);
+    CHECK(std::all_of(state->pendingWriteDescriptors.begin(), state->pendingWriteDescriptors.end(),
+        [](const auto& entry) { return entry.binding == Binding::STORAGE_IMAGE; }));
+}
+
+// an unregistered id may still be referenced by frames in flight, it must only come back once
+// FRAME_OVERLAP frames have passed
+TEST(descriptors, recycling_waits_for_frames_in_flight) {
+    auto state = createState();
+    const auto id = descriptors::registerCombinedSampler(state.get(), VK_NULL_HANDLE, VK_NULL_HANDLE);
+    descriptors::unregister(state.get(), id);
+
+    for (u32 frame = 0; frame < config::renderer::FRAME_OVERLAP; frame++) {
+        descriptors::recycleRetired(state.get());
+        CHECK(descriptors::registerCombinedSampler(state.get(), VK_NULL_HANDLE, VK_NULL_HANDLE) != id);
+        state->frameNumber++;
+    }
+    descriptors::recycleRetired(state.get());
+    CHECK(state->retiredDescriptorIds.empty());
+    CHECK(descriptors::registerCombinedSampler(state.get(), VK_NULL_HANDLE, VK_NULL_HANDLE) == id);
+}
+
+TEST(descriptors, bindings_recycle_independently) {
+    auto state = createState();
+    const auto sampler = descriptors::registerCombinedSampler(state.get(), VK_NULL_HANDLE, VK_NULL_HANDLE);
+    const auto image = descriptors::registerStorageImage(state.get(), VK_NULL_HANDLE);
+    const auto buffer = descriptors::registerStorageBuffer(state.get(), VK_NULL_HANDLE, 0, 16);
+    CHECK((u32)sampler == 0 && (u32)image == 0 && (u32)buffer == 0);
+
+    descriptors::unregister(state.get(), image);
+    state->frameNumber += config::renderer::FRAME_OVERLAP;
+    descriptors::recycleRetired(state.get());
+    CHECK(state->availableDescriptorId.storageImage.size() == 1);
+    CHECK(state->availableDescriptorId.combinedSampler.empty());
+    CHECK(state->availableDescriptorId.storageBuffer.empty());
+}
+
+TEST(descriptors, exhaustion_returns_invalid) {
+    auto state = createState();
+    std::vector<UniformBufferId> ids;
+    for (u32 i = 0; i < config::renderer::MAX_UNIFORM_BUFFER_COUNT; i++)
+        ids.push_back(descriptors::registerUniformBuffer(state.get(), VK_NULL_HANDLE, 0, 16));
+    CHECK(std::find(ids.begin(), ids.end(), UniformBufferId::INVALID) == ids.end());
+
+    const usize writes = state->pendingWriteDescriptors.size();
+    CHECK(descriptors::registerUniformBuffer(state.get(), VK_NULL_HANDLE, 0, 16) == UniformBufferId::INVALID);
+    CHECK(state->pendingWriteDescriptors.size() == writes);
+
+    // unregistering INVALID is a no-op, a recycled id makes room again
+    descriptors::unregister(state.get(), UniformBufferId::INVALID);
+    descriptors::unregister(state.get(), ids.back());
+    CHECK(state->retiredDescriptorIds.size() == 1);
+    state->frameNumber += config::renderer::FRAME_OVERLAP;
+    descriptors::recycleRetired(state.get());
+    CHECK(descriptors::registerUniformBuffer(state.get(), VK_NULL_HANDLE, 0, 16) == ids.back());
+}
+
+// churn like texture streaming does: ids are swapped every frame, live ids must never alias
+TEST(descriptors, stress_churn) {
+    auto state = createState();
+    std::vector<CombinedSamplerId> live;
+    for (u32 frame = 0; frame < config::test::STRESS_ITERATIONS / 10; frame++) {
+        descriptors::recycleRetired(state.get());
+        for (u32 i = 0; i < frame % 9 && !live.empty(); i++) {
+            descriptors::unregister(state.get(), live.back());
+            live.pop_back();
+        }
+        for (u32 i = 0; i < 8; i++)
+            if (live.size() < 1000 && (frame + i) % 2 == 0) live.push_back(descriptors::registerCombinedSampler(state.get(), VK_NULL_HANDLE, VK_NULL_HANDLE));
+        state->pendingWriteDescriptors.clear();
+        state->frameNumber++;
+
+        std::set<CombinedSamplerId> unique(live.begin(), live.end());
+        CHECK(unique.size() == live.size());
+        for (const auto& retired : state->retiredDescriptorIds)
+            CHECK(!unique.contains((CombinedSamplerId)retired.id));
+    }
+    CHECK(state->nextAvailableDecriptorId.combinedSampler <= 1000 + 8 * config::renderer::FRAME_OVERLAP + 8);
+}
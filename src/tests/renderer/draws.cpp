@@ -0,0 +1,30 @@
+#include <renderer/internal/draws.hpp>
+
+#include <subsystems/jobs.hpp>
+
+#include <random>
+
+// split into blocks over the job system, equal keys keep their order and shared digits are skipped
+TEST(draws, radix_sort_is_stable) {
+    jobs::init(3);
+    std::mt19937_64 random(7);
+    std::vector<DrawKey> keys(config::renderer::DRAW_SORT_MIN_BLOCK * 3 + 5), scratch;
+    for (u32 i = 0; i < keys.size(); i++)
+        keys[i] = { draws::makeKey(draws::Pass(random() % 2), (u32)random() % 8, (u32)random() % 64, (u32)random() % 16, 0), i };
+    auto expected = keys;
+    std::stable_sort(expected.begin(), expected.end(), [](const DrawKey& a, const DrawKey& b) { return a.key < b.key; });
+    draws::radixSort(&keys, &scratch);
+    CHECK(std::equal(keys.begin(), keys.end(), expected.begin(), [](const DrawKey& a, const DrawKey& b) { return a.draw == b.draw; }));
+    jobs::deinit();
+}
+
+// pass wins over pipeline, pipeline over material and material over depth. depth buckets grow with
+// distance and clamp at both ends
+TEST(draws, keys_order_by_pass_pipeline_material_depth) {
+    CHECK(draws::makeKey(draws::Pass::OPAQUE, 7, 0xffff, 0xffff, 0xffffff) < draws::makeKey(draws::Pass::MASKED, 0, 0, 0, 0));
+    CHECK(draws::makeKey(draws::Pass::OPAQUE, 1, 0xffff, 0xffff, 0) < draws::makeKey(draws::Pass::OPAQUE, 2, 0, 0, 0));
+    CHECK(draws::makeKey(draws::Pass::OPAQUE, 1, 2, 0xffff, 0) < draws::makeKey(draws::Pass::OPAQUE, 1, 3, 0, 0));
+    const Camera camera;
+    CHECK(draws::depthBucket(camera, 1.f) < draws::depthBucket(camera, 2.f));
+    CHECK(draws::depthBucket(camera, 0.f) == 0 && draws::depthBucket(camera, 1e9f) == draws::DEPTH_BUCKETS - 1);
+}
@@ -0,0 +1,37 @@
+#include <renderer/internal/instances.hpp>
+
+#include <cstring>
+
+TEST(instances, dirty_ranges_merge_small_gaps) {
+    std::vector<u32> dirty = { 9, 2, 3, 3, 40, 4, 12, 41 };
+    const auto ranges = vkres::dirtyRanges(&dirty, 3);
+    CHECK(ranges.size() == 3);
+    CHECK(ranges[0].first == 2 && ranges[0].count == 3);
+    CHECK(ranges[1].first == 9 && ranges[1].count == 4);
+    CHECK(ranges[2].first == 40 && ranges[2].count == 2);
+    CHECK(dirty.size() == 7);
+}
+
+// only changed instances are uploaded, a moved one once more so its previous transform catches up
+TEST(instances, uploads_only_dirty_instances) {
+    auto state = createState();
+    const glm::mat4 identity = glm::mat4(1.f);
+    for (u32 i = 0; i < 64; i++)
+        instances::add(state.get(), { .transform = identity });
+    CHECK(instances::collect(state.get()).size() == 1);
+    CHECK(instances::collect(state.get()).empty());
+
+    const glm::mat4 moved = glm::translate(glm::mat4(1.f), glm::vec3(1.f, 0.f, 0.f));
+    instances::setTransform(state.get(), 10, moved);
+    instances::setMaterial(state.get(), 50, 3);
+    auto ranges = instances::collect(state.get());
+    CHECK(ranges.size() == 2);
+    CHECK(std::memcmp(&state->instanceBuffer.data[10].transform, &moved, sizeof(glm::mat4)) == 0);
+    CHECK(std::memcmp(&state->instanceBuffer.data[10].previousTransform, &identity, sizeof(glm::mat4)) == 0);
+    CHECK(state->instanceBuffer.data[50].material == 3);
+
+    ranges = instances::collect(state.get());
+    CHECK(ranges.size() == 1 && ranges[0].first == 10 && ranges[0].count == 1);
+    CHECK(std::memcmp(&state->instanceBuffer.data[10].previousTransform, &moved, sizeof(glm::mat4)) == 0);
+    CHECK(instances::collect(state.get()).empty());
+}
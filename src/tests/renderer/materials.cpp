@@ -0,0 +1,36 @@
+#include <renderer/internal/materials.hpp>
+
+// loaded surfaces get ids past the source's first material, instance overrides win over them
+TEST(materials, assigns_and_resolves_ids) {
+    auto state = createState();
+    materials::add(state.get(), {});
+    const u32 first = materials::add(state.get(), { .baseColorTexture = (CombinedSamplerId)3 });
+    materials::add(state.get(), { .alphaCutoff = .25f, .features = MATERIAL_ALPHA_TEST | MATERIAL_TEXTURED });
+    CHECK(materials::get(state.get(), first).features == MATERIAL_TEXTURED);
+    CHECK(materials::get(state.get(), first + 1).features == MATERIAL_ALPHA_TEST);
+
+    auto mesh = std::make_shared<MeshAsset>();
+    mesh->surfaces = { { .material = 1 }, { .material = NO_MATERIAL } };
+    mesh->lods = { { .surfaces = mesh->surfaces } };
+    const std::shared_ptr<MeshAsset> meshes[] = { mesh };
+    materials::assign(meshes, first);
+    CHECK(mesh->surfaces[0].material == first + 1 && mesh->lods[0].surfaces[0].material == first + 1);
+    CHECK(mesh->surfaces[1].material == DEFAULT_MATERIAL);
+
+    MeshInstance instance = { .mesh = mesh, .transform = glm::mat4(1.f) };
+    CHECK(materials::resolve(instance, mesh->surfaces[0]) == first + 1);
+    instance.material = first;
+    CHECK(materials::resolve(instance, mesh->surfaces[1]) == first);
+
+    state->materials.dirty.clear();
+    materials::set(state.get(), first, { .baseColor = glm::vec4(.5f) });
+    CHECK(state->materials.dirty.size() == 1 && state->materials.dirty[0] == first);
+    CHECK(materials::get(state.get(), first).features == 0);
+
+    // streaming moves a texture to a new id, only the materials sampling it follow
+    materials::set(state.get(), first, { .baseColorTexture = (CombinedSamplerId)3 });
+    state->materials.dirty.clear();
+    materials::replaceTexture(state.get(), (CombinedSamplerId)3, (CombinedSamplerId)9);
+    CHECK(materials::get(state.get(), first).baseColorTexture == (CombinedSamplerId)9);
+    CHECK(state->materials.dirty.size() == 1 && state->materials.dirty[0] == first);
+}
@@ -0,0 +1,77 @@
+#include <renderer/internal/reflection.hpp>
+
+// a hand assembled compute shader: 16x16x1 workgroup, push constants { uint; float4; uint* }, a storage
+// image array at set 0 binding 2 and one specialization constant
+namespace {
+    std::vector<u32> computeSpirv(u32 imageBinding, u32 addressStride = 4) {
+        std::vector<u32> code = { reflection::spv::MAGIC, 0x00010500, 0, 64, 0 };
+        const auto op = [&](u32 opcode, std::initializer_list<u32> operands) {
+            code.push_back((u32)(operands.size() + 1) << 16 | opcode);
+            code.insert(code.end(), operands);
+        };
+        op(reflection::spv::OP_ENTRY_POINT, { reflection::spv::MODEL_COMPUTE, 1, 0x6e69616d, 0 }); // "main"
+        op(reflection::spv::OP_EXECUTION_MODE, { 1, reflection::spv::MODE_LOCAL_SIZE, 16, 16, 1 });
+        op(reflection::spv::OP_DECORATE, { 10, reflection::spv::DECORATION_DESCRIPTOR_SET, 0 });
+        op(reflection::spv::OP_DECORATE, { 10, reflection::spv::DECORATION_BINDING, imageBinding });
+        op(reflection::spv::OP_DECORATE, { 20, reflection::spv::DECORATION_SPEC_ID, 7 });
+        op(reflection::spv::OP_MEMBER_DECORATE, { 30, 0, reflection::spv::DECORATION_OFFSET, 0 });
+        op(reflection::spv::OP_MEMBER_DECORATE, { 30, 1, reflection::spv::DECORATION_OFFSET, 16 });
+        op(reflection::spv::OP_MEMBER_DECORATE, { 30, 2, reflection::spv::DECORATION_OFFSET, 32 });
+        op(reflection::spv::OP_DECORATE, { 33, reflection::spv::DECORATION_ARRAY_STRIDE, addressStride });
+        op(reflection::spv::OP_TYPE_INT, { 2, 32, 0 });
+        op(reflection::spv::OP_TYPE_FLOAT, { 3, 32 });
+        op(reflection::spv::OP_TYPE_VECTOR, { 4, 3, 4 });
+        op(reflection::spv::OP_TYPE_IMAGE, { 5, 3, 1, 0, 0, 0, 2, 0 });
+        op(reflection::spv::OP_TYPE_RUNTIME_ARRAY, { 6, 5 });
+        op(reflection::spv::OP_TYPE_POINTER, { 7, reflection::spv::STORAGE_UNIFORM_CONSTANT, 6 });
+        op(reflection::spv::OP_TYPE_POINTER, { 33, reflection::spv::STORAGE_PHYSICAL_STORAGE_BUFFER, 2 });
+        op(reflection::spv::OP_TYPE_STRUCT, { 30, 2, 4, 33 });
+        op(reflection::spv::OP_TYPE_POINTER, { 31, reflection::spv::STORAGE_PUSH_CONSTANT, 30 });
+        op(reflection::spv::OP_SPEC_CONSTANT, { 2, 20, 64 });
+        op(reflection::spv::OP_VARIABLE, { 7, 10, reflection::spv::STORAGE_UNIFORM_CONSTANT });
+        op(reflection::spv::OP_VARIABLE, { 31, 32, reflection::spv::STORAGE_PUSH_CONSTANT });
+        return code;
+    }
+}
+
+TEST(reflection, reads_compute_shader_interface) {
+    ShaderReflection reflected;
+    CHECK(reflection::reflect(computeSpirv(2), &reflected));
+    CHECK(reflected.stage == VK_SHADER_STAGE_COMPUTE_BIT);
+    CHECK((reflected.workgroupSize == std::array<u32, 3>{ 16, 16, 1 }));
+    CHECK(reflected.pushConstantSize == 40);
+    CHECK((reflected.pushConstantOffsets == std::vector<u32>{ 0, 16, 32 }));
+    CHECK((reflected.pushConstantStrides == std::vector<u32>{ 0, 0, 4 }));
+    CHECK(reflected.descriptors.size() == 1);
+    CHECK(reflected.descriptors[0].set == 0 && reflected.descriptors[0].binding == 2);
+    CHECK(reflected.descriptors[0].kind == Binding::STORAGE_IMAGE);
+    CHECK(reflected.specConstants.size() == 1);
+    CHECK(reflected.specConstants[0].id == 7 && reflected.specConstants[0].size == 4);
+
+    std::vector<u32> truncated = computeSpirv(2);
+    truncated.resize(truncated.size() - 2);
+    CHECK(!reflection::reflect(truncated, &reflected));
+}
+
+TEST(reflection, validates_against_layout_and_structs) {
+    ShaderReflection reflected;
+    CHECK(reflection::reflect(computeSpirv(2), &reflected));
+    CHECK(reflection::validateDescriptors(reflected, "test"));
+    CHECK(reflection::validatePushConstants(reflected, "test", {}));
+    CHECK(reflection::validatePushConstants(reflected, "test", { .size = 40, .offsets = { 0, 16, 32 }, .strides = { 0, 0, 4 } }));
+    CHECK(!reflection::validatePushConstants(reflected, "test", { .size = 16, .offsets = { 0, 16, 32 } }));
+    CHECK(!reflection::validatePushConstants(reflected, "test", { .size = 40, .offsets = { 0, 8, 32 } }));
+
+    // a vec3 first struct indexed with std430 layout steps 32 bytes where the c++ struct has 24
+    CHECK(reflection::reflect(computeSpirv(2, 32), &reflected));
+    CHECK(!reflection::validatePushConstants(reflected, "test", { .size = 40, .offsets = { 0, 16, 32 }, .strides = { 0, 0, 24 } }));
+    CHECK(reflection::validatePushConstants(reflected, "test", { .size = 40, .offsets = { 0, 16, 32 } }));
+
+    CHECK(reflection::reflect(computeSpirv(2), &reflected));
+    const VkSpecializationMapEntry wrongSize = { .constantID = 7, .offset = 0, .size = 8 };
+    CHECK(!reflection::validateSpecialization({ &reflected, 1 }, "test", { &wrongSize, 1 }));
+
+    // a storage image at the acceleration structure binding
+    CHECK(reflection::reflect(computeSpirv(3), &reflected));
+    CHECK(!reflection::validateDescriptors(reflected, "test"));
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <common.hpp>
+#include <config.hpp>
+
+// minimal test registry for flux-test. TEST bodies register themselves at static init, CHECK records a
+// failure and keeps going so one run reports every broken expectation. checks are thread safe
+namespace flux::test {
+
+    using Fn = void(*)();
+
+    struct Case {
+        const char* suite;
+        const char* name;
+        Fn fn;
+    };
+
+    std::vector<Case>& registry();
+
+    struct Register {
+        Register(const char* suite, const char* name, Fn fn);
+    };
+
+    void fail(const char* expression, const char* file, i32 line);
+
+    // failures recorded since the last call
+    u32 takeFailures();
+
+    // runs fn on config::test::STRESS_THREADS plain threads at once, fn receives the thread index
+    void stress(const std::function<void(u32 thread)>& fn);
+
+}
+
+#define TEST(suite, name) \
+    static void test_##suite##_##name(); \
+    static const flux::test::Register register_##suite##_##name(#suite, #name, test_##suite##_##name); \
+    static void test_##suite##_##name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) flux::test::fail(#expression, __FILE__, __LINE__); } while (0)